@@ -0,0 +1,63 @@
+"""Benchmarks of reading and writing ORC files with wide schemas.
+
+Usage: python benchmarks/wide_schema.py [NUM_OF_COLUMNS] [NUM_OF_ROWS]
+"""
+
+import io
+import sys
+import time
+from typing import Any, Callable
+
+from pyorc import Reader, StructRepr, Writer
+
+
+def measure(name: str, func: Callable[[], Any], repeat: int = 3) -> None:
+    best = float("inf")
+    for _ in range(repeat):
+        start = time.perf_counter()
+        func()
+        best = min(best, time.perf_counter() - start)
+    print("{0:<40} {1:>10.2f} ms".format(name, best * 1000))
+
+
+def main(num_of_cols: int, num_of_rows: int) -> None:
+    names = ["col{0}".format(idx) for idx in range(num_of_cols)]
+    schema = "struct<{0}>".format(",".join("{0}:int".format(name) for name in names))
+    data = io.BytesIO()
+    start = time.perf_counter()
+    with Writer(data, schema, stripe_size=1024 * 1024) as writer:
+        row = tuple(range(num_of_cols))
+        for _ in range(num_of_rows):
+            writer.write(row)
+    print("{0:<40} {1:>10.2f} ms".format("write", (time.perf_counter() - start) * 1000))
+    print(
+        "{0} columns, {1} rows, {2} bytes".format(
+            num_of_cols, num_of_rows, len(data.getvalue())
+        )
+    )
+
+    measure("open (metadata only)", lambda: Reader(data, metadata_only=True))
+    measure("schema", lambda: Reader(data, metadata_only=True).schema)
+    reader = Reader(data, metadata_only=True)
+    _ = reader.schema
+    measure("schema (cached)", lambda: reader.schema, repeat=100)
+    measure(
+        "statistics of every column",
+        lambda: [reader[idx].statistics for idx in range(1, num_of_cols + 1)],
+    )
+    measure(
+        "stripe_statistics of every column", lambda: reader.stripe_statistics(names)
+    )
+    measure("read tuples", lambda: Reader(data).read())
+    measure("read dicts", lambda: Reader(data, struct_repr=StructRepr.DICT).read())
+    measure(
+        "read 10 projected columns",
+        lambda: Reader(data, column_names=names[:: max(num_of_cols // 10, 1)]).read(),
+    )
+
+
+if __name__ == "__main__":
+    main(
+        int(sys.argv[1]) if len(sys.argv) > 1 else 5000,
+        int(sys.argv[2]) if len(sys.argv) > 2 else 1000,
+    )
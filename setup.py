@@ -19,18 +19,34 @@ logging.basicConfig(format="%(levelname)s: %(message)s", level=logging.INFO)
 
 SOURCES = [
     "_pyorc.cpp",
+    "ArrowImport.cpp",
+    "BackgroundTask.cpp",
+    "Compaction.cpp",
     "Converter.cpp",
+    "MemoryPool.cpp",
+    "PartitionedWriter.cpp",
     "PyORCStream.cpp",
     "Reader.cpp",
+    "Reduction.cpp",
     "SearchArgument.cpp",
+    "Sort.cpp",
+    "VectorBatch.cpp",
     "Writer.cpp",
 ]
 
 HEADERS = [
+    "ArrowImport.h",
+    "BackgroundTask.h",
+    "Compaction.h",
     "Converter.h",
+    "MemoryPool.h",
+    "PartitionedWriter.h",
     "PyORCStream.h",
     "Reader.h",
+    "Reduction.h",
     "SearchArgument.h",
+    "Sort.h",
+    "VectorBatch.h",
     "Writer.h",
     "verguard.h",
 ]
@@ -0,0 +1,657 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+#include <pybind11/pybind11.h>
+
+#include "ArrowImport.h"
+
+namespace py = pybind11;
+
+enum ArrowSource
+{
+    ARROW_BOOL,
+    ARROW_INT8,
+    ARROW_UINT8,
+    ARROW_INT16,
+    ARROW_UINT16,
+    ARROW_INT32,
+    ARROW_UINT32,
+    ARROW_INT64,
+    ARROW_UINT64,
+    ARROW_FLOAT,
+    ARROW_DOUBLE,
+    ARROW_STRING,
+    ARROW_LARGE_STRING,
+    ARROW_DATE32,
+    ARROW_DATE64,
+    ARROW_TIMESTAMP,
+    ARROW_DECIMAL128,
+    ARROW_LIST,
+    ARROW_LARGE_LIST,
+    ARROW_MAP,
+    ARROW_STRUCT,
+    ARROW_UNSUPPORTED
+};
+
+static int
+parseFormat(const std::string& format, ArrowNode& node)
+{
+    static const char* simpleFormats[] = { "b", "c", "C", "s", "S", "i", "I", "l",
+                                           "L", "f", "g", "u", "U", "z", "Z", "tdD",
+                                           "tdm" };
+    static const int simpleSources[] = { ARROW_BOOL,         ARROW_INT8,
+                                         ARROW_UINT8,        ARROW_INT16,
+                                         ARROW_UINT16,       ARROW_INT32,
+                                         ARROW_UINT32,       ARROW_INT64,
+                                         ARROW_UINT64,       ARROW_FLOAT,
+                                         ARROW_DOUBLE,       ARROW_STRING,
+                                         ARROW_LARGE_STRING, ARROW_STRING,
+                                         ARROW_LARGE_STRING, ARROW_DATE32,
+                                         ARROW_DATE64 };
+    for (size_t i = 0; i < sizeof(simpleSources) / sizeof(simpleSources[0]); ++i) {
+        if (format == simpleFormats[i]) {
+            return simpleSources[i];
+        }
+    }
+    if (format == "+l") {
+        return ARROW_LIST;
+    } else if (format == "+L") {
+        return ARROW_LARGE_LIST;
+    } else if (format == "+m") {
+        return ARROW_MAP;
+    } else if (format == "+s") {
+        return ARROW_STRUCT;
+    } else if (format.size() >= 4 && format.compare(0, 2, "ts") == 0 &&
+               format[3] == ':') {
+        switch (format[2]) {
+            case 's':
+                node.unitsPerSecond = 1;
+                return ARROW_TIMESTAMP;
+            case 'm':
+                node.unitsPerSecond = 1000;
+                return ARROW_TIMESTAMP;
+            case 'u':
+                node.unitsPerSecond = 1000000;
+                return ARROW_TIMESTAMP;
+            case 'n':
+                node.unitsPerSecond = 1000000000;
+                return ARROW_TIMESTAMP;
+            default:
+                return ARROW_UNSUPPORTED;
+        }
+    } else if (format.compare(0, 2, "d:") == 0) {
+        /* Only the 128 bit decimals are supported: "d:precision,scale" or
+           "d:precision,scale,128". */
+        size_t lastComma = format.rfind(',');
+        if (lastComma == std::string::npos) {
+            return ARROW_UNSUPPORTED;
+        }
+        size_t commas = std::count(format.begin(), format.end(), ',');
+        bool is128 = format.substr(lastComma) == ",128";
+        if (commas == 1 || (commas == 2 && is128)) {
+            return ARROW_DECIMAL128;
+        }
+    }
+    return ARROW_UNSUPPORTED;
+}
+
+static int32_t
+decimalScale(const std::string& format)
+{
+    size_t start = format.find(',') + 1;
+    size_t end = format.find(',', start);
+    return std::stoi(format.substr(start, end - start));
+}
+
+static bool
+isInteger(int source)
+{
+    return source >= ARROW_INT8 && source <= ARROW_UINT64;
+}
+
+static bool
+isCompatible(const orc::Type& type, int source)
+{
+    switch (static_cast<int64_t>(type.getKind())) {
+        case orc::BOOLEAN:
+            return source == ARROW_BOOL;
+        case orc::BYTE:
+        case orc::SHORT:
+        case orc::INT:
+        case orc::LONG:
+            return isInteger(source);
+        case orc::FLOAT:
+        case orc::DOUBLE:
+            return source == ARROW_FLOAT || source == ARROW_DOUBLE;
+        case orc::STRING:
+        case orc::VARCHAR:
+        case orc::CHAR:
+        case orc::BINARY:
+            return source == ARROW_STRING || source == ARROW_LARGE_STRING;
+        case orc::DATE:
+            return source == ARROW_DATE32 || source == ARROW_DATE64;
+        case orc::TIMESTAMP:
+        case orc::TIMESTAMP_INSTANT:
+            return source == ARROW_TIMESTAMP;
+        case orc::DECIMAL:
+            return source == ARROW_DECIMAL128;
+        case orc::LIST:
+            return source == ARROW_LIST || source == ARROW_LARGE_LIST;
+        case orc::MAP:
+            return source == ARROW_MAP;
+        case orc::STRUCT:
+            return source == ARROW_STRUCT;
+        default:
+            return false;
+    }
+}
+
+static ArrowNode
+buildNode(const orc::Type& type, const ArrowSchema& schema, const std::string& path)
+{
+    ArrowNode node;
+    node.dictionarySource = ARROW_UNSUPPORTED;
+    node.unitsPerSecond = 0;
+    node.checked = false;
+    std::string format(schema.format);
+    node.source = parseFormat(format, node);
+    bool compatible = false;
+    if (schema.dictionary != nullptr) {
+        ArrowNode dictNode;
+        node.dictionarySource = parseFormat(schema.dictionary->format, dictNode);
+        compatible = isInteger(node.source) &&
+                     (node.dictionarySource == ARROW_STRING ||
+                      node.dictionarySource == ARROW_LARGE_STRING) &&
+                     isCompatible(type, node.dictionarySource);
+    } else {
+        compatible = isCompatible(type, node.source);
+    }
+    if (!compatible) {
+        std::stringstream errmsg;
+        errmsg << "Arrow type '" << format
+               << (schema.dictionary != nullptr ? " (dictionary)" : "")
+               << "' of column '" << path << "' is not compatible with ORC type '"
+               << type.toString() << "'";
+        throw py::type_error(errmsg.str());
+    }
+    switch (node.source) {
+        case ARROW_DECIMAL128:
+            if (decimalScale(format) != static_cast<int32_t>(type.getScale())) {
+                std::stringstream errmsg;
+                errmsg << "Arrow decimal scale of column '" << path
+                       << "' does not match the ORC type '" << type.toString() << "'";
+                throw py::value_error(errmsg.str());
+            }
+            break;
+        case ARROW_LIST:
+        case ARROW_LARGE_LIST:
+            node.children.push_back(
+              buildNode(*type.getSubtype(0), *schema.children[0], path + ".item"));
+            break;
+        case ARROW_MAP: {
+            const ArrowSchema& entries = *schema.children[0];
+            if (entries.n_children != 2) {
+                throw py::type_error("Arrow map of column '" + path +
+                                     "' must have key and value fields");
+            }
+            node.children.push_back(
+              buildNode(*type.getSubtype(0), *entries.children[0], path + ".key"));
+            node.children.push_back(
+              buildNode(*type.getSubtype(1), *entries.children[1], path + ".value"));
+            break;
+        }
+        case ARROW_STRUCT:
+            for (size_t i = 0; i < type.getSubtypeCount(); ++i) {
+                const std::string& name = type.getFieldName(i);
+                std::string childPath = path.empty() ? name : path + "." + name;
+                int64_t idx = 0;
+                while (idx < schema.n_children &&
+                       (schema.children[idx]->name == nullptr ||
+                        name != schema.children[idx]->name)) {
+                    ++idx;
+                }
+                if (idx == schema.n_children) {
+                    throw py::value_error("Missing column '" + childPath +
+                                          "' from the Arrow data");
+                }
+                node.fieldIndices.push_back(idx);
+                node.children.push_back(
+                  buildNode(*type.getSubtype(i), *schema.children[idx], childPath));
+            }
+            break;
+        default:
+            break;
+    }
+    node.checked = node.source == ARROW_UINT64 ||
+                   (node.source == ARROW_DECIMAL128 && type.getPrecision() != 0 &&
+                    type.getPrecision() <= 18);
+    for (const ArrowNode& child : node.children) {
+        node.checked = node.checked || child.checked;
+    }
+    return node;
+}
+
+ArrowImport::ArrowImport(const orc::Type& type_, const ArrowSchema& schema)
+  : type(type_)
+{
+    root = buildNode(type, schema, "");
+}
+
+template <typename T>
+static T
+valueAt(const ArrowArray& array, int buffer, int64_t idx)
+{
+    T value;
+    const char* data = static_cast<const char*>(array.buffers[buffer]);
+    std::memcpy(&value, data + idx * sizeof(T), sizeof(T));
+    return value;
+}
+
+static bool
+bitAt(const void* bitmap, int64_t idx)
+{
+    return (static_cast<const uint8_t*>(bitmap)[idx >> 3] >> (idx & 7)) & 1;
+}
+
+static int64_t
+floorDiv(int64_t value, int64_t divisor)
+{
+    int64_t res = value / divisor;
+    if (value % divisor != 0 && value < 0) {
+        --res;
+    }
+    return res;
+}
+
+static int64_t
+integerAt(const ArrowArray& array, int source, int64_t idx)
+{
+    switch (source) {
+        case ARROW_INT8:
+            return valueAt<int8_t>(array, 1, idx);
+        case ARROW_UINT8:
+            return valueAt<uint8_t>(array, 1, idx);
+        case ARROW_INT16:
+            return valueAt<int16_t>(array, 1, idx);
+        case ARROW_UINT16:
+            return valueAt<uint16_t>(array, 1, idx);
+        case ARROW_INT32:
+            return valueAt<int32_t>(array, 1, idx);
+        case ARROW_UINT32:
+            return valueAt<uint32_t>(array, 1, idx);
+        case ARROW_INT64:
+            return valueAt<int64_t>(array, 1, idx);
+        default: {
+            uint64_t value = valueAt<uint64_t>(array, 1, idx);
+            if (value > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+                std::stringstream errmsg;
+                errmsg << "Arrow value " << value << " is out of range";
+                throw py::value_error(errmsg.str());
+            }
+            return static_cast<int64_t>(value);
+        }
+    }
+}
+
+static int64_t
+offsetAt(const ArrowArray& array, bool large, int64_t idx)
+{
+    if (large) {
+        return valueAt<int64_t>(array, 1, idx);
+    } else {
+        return valueAt<int32_t>(array, 1, idx);
+    }
+}
+
+static void
+ensureCapacity(orc::ColumnVectorBatch* batch, uint64_t size)
+{
+    if (batch->capacity < size) {
+        batch->resize(std::max(size, 2 * batch->capacity));
+    }
+}
+
+void
+ArrowImport::fillBatch(const orc::Type& orcType,
+                       const ArrowNode& node,
+                       const ArrowArray& array,
+                       int64_t start,
+                       uint64_t count,
+                       orc::ColumnVectorBatch* batch,
+                       uint64_t dest) const
+{
+    ensureCapacity(batch, dest + count);
+    int64_t base = array.offset + start;
+    char* notNull = batch->notNull.data() + dest;
+    bool hasNulls = false;
+    if (array.null_count == 0 || array.buffers[0] == nullptr) {
+        std::memset(notNull, 1, count);
+    } else {
+        for (uint64_t i = 0; i < count; ++i) {
+            notNull[i] = bitAt(array.buffers[0], base + i);
+            hasNulls |= !notNull[i];
+        }
+    }
+    batch->hasNulls = (dest != 0 && batch->hasNulls) || hasNulls;
+    if (node.dictionarySource != ARROW_UNSUPPORTED) {
+        auto* strBatch = dynamic_cast<orc::StringVectorBatch*>(batch);
+        const ArrowArray& dict = *array.dictionary;
+        bool large = node.dictionarySource == ARROW_LARGE_STRING;
+        const char* data = static_cast<const char*>(dict.buffers[2]);
+        for (uint64_t i = 0; i < count; ++i) {
+            if (!notNull[i]) {
+                continue;
+            }
+            int64_t idx = dict.offset + integerAt(array, node.source, base + i);
+            int64_t begin = offsetAt(dict, large, idx);
+            strBatch->data[dest + i] = const_cast<char*>(data + begin);
+            strBatch->length[dest + i] = offsetAt(dict, large, idx + 1) - begin;
+        }
+        batch->numElements = dest + count;
+        return;
+    }
+    switch (node.source) {
+        case ARROW_BOOL: {
+            auto* longBatch = dynamic_cast<orc::LongVectorBatch*>(batch);
+            for (uint64_t i = 0; i < count; ++i) {
+                longBatch->data[dest + i] = bitAt(array.buffers[1], base + i);
+            }
+            break;
+        }
+        case ARROW_INT8:
+        case ARROW_UINT8:
+        case ARROW_INT16:
+        case ARROW_UINT16:
+        case ARROW_INT32:
+        case ARROW_UINT32:
+        case ARROW_UINT64: {
+            auto* longBatch = dynamic_cast<orc::LongVectorBatch*>(batch);
+            for (uint64_t i = 0; i < count; ++i) {
+                longBatch->data[dest + i] =
+                  notNull[i] ? integerAt(array, node.source, base + i) : 0;
+            }
+            break;
+        }
+        case ARROW_INT64: {
+            auto* longBatch = dynamic_cast<orc::LongVectorBatch*>(batch);
+            std::memcpy(longBatch->data.data() + dest,
+                        static_cast<const int64_t*>(array.buffers[1]) + base,
+                        count * sizeof(int64_t));
+            break;
+        }
+        case ARROW_FLOAT: {
+            auto* doubleBatch = dynamic_cast<orc::DoubleVectorBatch*>(batch);
+            for (uint64_t i = 0; i < count; ++i) {
+                doubleBatch->data[dest + i] = valueAt<float>(array, 1, base + i);
+            }
+            break;
+        }
+        case ARROW_DOUBLE: {
+            auto* doubleBatch = dynamic_cast<orc::DoubleVectorBatch*>(batch);
+            std::memcpy(doubleBatch->data.data() + dest,
+                        static_cast<const double*>(array.buffers[1]) + base,
+                        count * sizeof(double));
+            break;
+        }
+        case ARROW_STRING:
+        case ARROW_LARGE_STRING: {
+            auto* strBatch = dynamic_cast<orc::StringVectorBatch*>(batch);
+            bool large = node.source == ARROW_LARGE_STRING;
+            const char* data = static_cast<const char*>(array.buffers[2]);
+            for (uint64_t i = 0; i < count; ++i) {
+                int64_t begin = offsetAt(array, large, base + i);
+                int64_t end = offsetAt(array, large, base + i + 1);
+                strBatch->data[dest + i] = const_cast<char*>(data + begin);
+                strBatch->length[dest + i] = end - begin;
+            }
+            break;
+        }
+        case ARROW_DATE32: {
+            auto* longBatch = dynamic_cast<orc::LongVectorBatch*>(batch);
+            for (uint64_t i = 0; i < count; ++i) {
+                longBatch->data[dest + i] = valueAt<int32_t>(array, 1, base + i);
+            }
+            break;
+        }
+        case ARROW_DATE64: {
+            auto* longBatch = dynamic_cast<orc::LongVectorBatch*>(batch);
+            for (uint64_t i = 0; i < count; ++i) {
+                longBatch->data[dest + i] =
+                  floorDiv(valueAt<int64_t>(array, 1, base + i), 86400000);
+            }
+            break;
+        }
+        case ARROW_TIMESTAMP: {
+            auto* tsBatch = dynamic_cast<orc::TimestampVectorBatch*>(batch);
+            int64_t nanosPerUnit = 1000000000 / node.unitsPerSecond;
+            for (uint64_t i = 0; i < count; ++i) {
+                int64_t value = valueAt<int64_t>(array, 1, base + i);
+                int64_t seconds = floorDiv(value, node.unitsPerSecond);
+                tsBatch->data[dest + i] = seconds;
+                tsBatch->nanoseconds[dest + i] =
+                  (value - seconds * node.unitsPerSecond) * nanosPerUnit;
+            }
+            break;
+        }
+        case ARROW_DECIMAL128: {
+            const char* data = static_cast<const char*>(array.buffers[1]);
+            if (orcType.getPrecision() == 0 || orcType.getPrecision() > 18) {
+                auto* decBatch = dynamic_cast<orc::Decimal128VectorBatch*>(batch);
+                decBatch->precision = orcType.getPrecision();
+                decBatch->scale = orcType.getScale();
+                for (uint64_t i = 0; i < count; ++i) {
+                    uint64_t low;
+                    int64_t high;
+                    std::memcpy(&low, data + (base + i) * 16, sizeof(low));
+                    std::memcpy(&high, data + (base + i) * 16 + 8, sizeof(high));
+                    decBatch->values[dest + i] = orc::Int128(high, low);
+                }
+            } else {
+                auto* decBatch = dynamic_cast<orc::Decimal64VectorBatch*>(batch);
+                decBatch->precision = orcType.getPrecision();
+                decBatch->scale = orcType.getScale();
+                for (uint64_t i = 0; i < count; ++i) {
+                    int64_t low;
+                    int64_t high;
+                    std::memcpy(&low, data + (base + i) * 16, sizeof(low));
+                    std::memcpy(&high, data + (base + i) * 16 + 8, sizeof(high));
+                    if (notNull[i] && high != (low < 0 ? -1 : 0)) {
+                        throw py::value_error(
+                          "Arrow decimal value is out of range for ORC type " +
+                          orcType.toString());
+                    }
+                    decBatch->values[dest + i] = low;
+                }
+            }
+            break;
+        }
+        case ARROW_STRUCT: {
+            auto* structBatch = dynamic_cast<orc::StructVectorBatch*>(batch);
+            for (size_t i = 0; i < orcType.getSubtypeCount(); ++i) {
+                fillBatch(*orcType.getSubtype(i),
+                          node.children[i],
+                          *array.children[node.fieldIndices[i]],
+                          base,
+                          count,
+                          structBatch->fields[i],
+                          dest);
+            }
+            break;
+        }
+        case ARROW_LIST:
+        case ARROW_LARGE_LIST:
+        case ARROW_MAP: {
+            /* The child values of the valid entries are copied in contiguous
+               runs, skipping the values that might belong to null entries. */
+            bool large = node.source == ARROW_LARGE_LIST;
+            int64_t* offsets = nullptr;
+            if (node.source == ARROW_MAP) {
+                offsets = dynamic_cast<orc::MapVectorBatch*>(batch)->offsets.data();
+            } else {
+                offsets = dynamic_cast<orc::ListVectorBatch*>(batch)->offsets.data();
+            }
+            if (dest == 0) {
+                offsets[0] = 0;
+            }
+            int64_t runStart = -1;
+            int64_t runEnd = -1;
+            uint64_t childDest = static_cast<uint64_t>(offsets[dest]);
+            auto flushRun = [&]() {
+                if (runStart < 0 || runEnd <= runStart) {
+                    return;
+                }
+                uint64_t size = static_cast<uint64_t>(runEnd - runStart);
+                if (node.source == ARROW_MAP) {
+                    auto* mapBatch = dynamic_cast<orc::MapVectorBatch*>(batch);
+                    const ArrowArray& entries = *array.children[0];
+                    fillBatch(*orcType.getSubtype(0),
+                              node.children[0],
+                              *entries.children[0],
+                              entries.offset + runStart,
+                              size,
+                              mapBatch->keys.get(),
+                              childDest);
+                    fillBatch(*orcType.getSubtype(1),
+                              node.children[1],
+                              *entries.children[1],
+                              entries.offset + runStart,
+                              size,
+                              mapBatch->elements.get(),
+                              childDest);
+                } else {
+                    auto* listBatch = dynamic_cast<orc::ListVectorBatch*>(batch);
+                    fillBatch(*orcType.getSubtype(0),
+                              node.children[0],
+                              *array.children[0],
+                              runStart,
+                              size,
+                              listBatch->elements.get(),
+                              childDest);
+                }
+                childDest += size;
+            };
+            for (uint64_t i = 0; i < count; ++i) {
+                int64_t size = 0;
+                if (notNull[i]) {
+                    int64_t begin = offsetAt(array, large, base + i);
+                    int64_t end = offsetAt(array, large, base + i + 1);
+                    if (begin != runEnd) {
+                        flushRun();
+                        runStart = begin;
+                    }
+                    runEnd = end;
+                    size = end - begin;
+                }
+                offsets[dest + i + 1] = offsets[dest + i] + size;
+            }
+            flushRun();
+            break;
+        }
+        default:
+            throw py::type_error("Unsupported Arrow type");
+    }
+    batch->numElements = dest + count;
+}
+
+void
+ArrowImport::validateNode(const orc::Type& orcType,
+                          const ArrowNode& node,
+                          const ArrowArray& array,
+                          int64_t start,
+                          uint64_t count) const
+{
+    if (!node.checked) {
+        return;
+    }
+    int64_t base = array.offset + start;
+    bool hasNulls = array.null_count != 0 && array.buffers[0] != nullptr;
+    auto isValid = [&](uint64_t i) {
+        return !hasNulls || bitAt(array.buffers[0], base + i);
+    };
+    switch (node.source) {
+        case ARROW_UINT64:
+            for (uint64_t i = 0; i < count; ++i) {
+                if (isValid(i)) {
+                    /* Raises for the values above the maximum of int64_t. */
+                    integerAt(array, node.source, base + i);
+                }
+            }
+            break;
+        case ARROW_DECIMAL128: {
+            const char* data = static_cast<const char*>(array.buffers[1]);
+            for (uint64_t i = 0; i < count; ++i) {
+                int64_t low;
+                int64_t high;
+                std::memcpy(&low, data + (base + i) * 16, sizeof(low));
+                std::memcpy(&high, data + (base + i) * 16 + 8, sizeof(high));
+                if (isValid(i) && high != (low < 0 ? -1 : 0)) {
+                    throw py::value_error(
+                      "Arrow decimal value is out of range for ORC type " +
+                      orcType.toString());
+                }
+            }
+            break;
+        }
+        case ARROW_STRUCT:
+            for (size_t i = 0; i < orcType.getSubtypeCount(); ++i) {
+                validateNode(*orcType.getSubtype(i),
+                             node.children[i],
+                             *array.children[node.fieldIndices[i]],
+                             base,
+                             count);
+            }
+            break;
+        case ARROW_LIST:
+        case ARROW_LARGE_LIST:
+        case ARROW_MAP: {
+            bool large = node.source == ARROW_LARGE_LIST;
+            for (uint64_t i = 0; i < count; ++i) {
+                if (!isValid(i)) {
+                    continue;
+                }
+                int64_t begin = offsetAt(array, large, base + i);
+                uint64_t size =
+                  static_cast<uint64_t>(offsetAt(array, large, base + i + 1) - begin);
+                if (node.source == ARROW_MAP) {
+                    const ArrowArray& entries = *array.children[0];
+                    validateNode(*orcType.getSubtype(0),
+                                 node.children[0],
+                                 *entries.children[0],
+                                 entries.offset + begin,
+                                 size);
+                    validateNode(*orcType.getSubtype(1),
+                                 node.children[1],
+                                 *entries.children[1],
+                                 entries.offset + begin,
+                                 size);
+                } else {
+                    validateNode(*orcType.getSubtype(0),
+                                 node.children[0],
+                                 *array.children[0],
+                                 begin,
+                                 size);
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void
+ArrowImport::validate(const ArrowArray& array) const
+{
+    validateNode(type, root, array, 0, static_cast<uint64_t>(array.length));
+}
+
+void
+ArrowImport::fill(const ArrowArray& array,
+                  uint64_t start,
+                  uint64_t count,
+                  orc::ColumnVectorBatch* batch) const
+{
+    fillBatch(type, root, array, static_cast<int64_t>(start), count, batch, 0);
+}
@@ -0,0 +1,100 @@
+#ifndef ARROW_IMPORT_H
+#define ARROW_IMPORT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "orc/OrcFile.hh"
+
+/* The structures of the Arrow C data interface, as they are defined in the
+   specification: https://arrow.apache.org/docs/format/CDataInterface.html */
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema
+{
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray
+{
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+#endif
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream
+{
+    int (*get_schema)(struct ArrowArrayStream*, struct ArrowSchema* out);
+    int (*get_next)(struct ArrowArrayStream*, struct ArrowArray* out);
+    const char* (*get_last_error)(struct ArrowArrayStream*);
+    void (*release)(struct ArrowArrayStream*);
+    void* private_data;
+};
+
+#endif
+
+/* The layout of an Arrow column, resolved against the matching ORC type. */
+struct ArrowNode
+{
+    int source;
+    int dictionarySource;
+    int64_t unitsPerSecond;
+    /* Whether a value of the column or of its children can be out of range
+       for the ORC type. */
+    bool checked;
+    std::vector<int64_t> fieldIndices;
+    std::vector<ArrowNode> children;
+};
+
+class ArrowImport
+{
+  private:
+    const orc::Type& type;
+    ArrowNode root;
+    void fillBatch(const orc::Type&,
+                   const ArrowNode&,
+                   const ArrowArray&,
+                   int64_t,
+                   uint64_t,
+                   orc::ColumnVectorBatch*,
+                   uint64_t) const;
+    void validateNode(const orc::Type&,
+                      const ArrowNode&,
+                      const ArrowArray&,
+                      int64_t,
+                      uint64_t) const;
+
+  public:
+    ArrowImport(const orc::Type&, const ArrowSchema&);
+    /* Raises ValueError if any value of the array cannot be imported. */
+    void validate(const ArrowArray&) const;
+    void fill(const ArrowArray&, uint64_t, uint64_t, orc::ColumnVectorBatch*) const;
+};
+
+#endif
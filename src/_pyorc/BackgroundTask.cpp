@@ -0,0 +1,68 @@
+#include "BackgroundTask.h"
+
+BackgroundTask::BackgroundTask()
+  : busy(false)
+  , stopping(false)
+{
+    thread = std::thread(&BackgroundTask::run, this);
+}
+
+BackgroundTask::~BackgroundTask()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [this] { return !busy; });
+        stopping = true;
+    }
+    cond.notify_all();
+    thread.join();
+}
+
+void
+BackgroundTask::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        cond.wait(lock, [this] { return busy || stopping; });
+        if (!busy) {
+            return;
+        }
+        std::function<void()> current = std::move(task);
+        lock.unlock();
+        try {
+            current();
+        } catch (...) {
+            lock.lock();
+            error = std::current_exception();
+            lock.unlock();
+        }
+        current = nullptr;
+        lock.lock();
+        busy = false;
+        cond.notify_all();
+    }
+}
+
+void
+BackgroundTask::submit(std::function<void()> func)
+{
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = std::move(func);
+        busy = true;
+    }
+    cond.notify_all();
+}
+
+void
+BackgroundTask::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [this] { return !busy; });
+    if (error) {
+        std::exception_ptr err = error;
+        error = nullptr;
+        std::rethrow_exception(err);
+    }
+}
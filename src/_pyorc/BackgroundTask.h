@@ -0,0 +1,31 @@
+#ifndef BACKGROUND_TASK_H
+#define BACKGROUND_TASK_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/* A single worker thread that runs one task at a time. The exception of a
+   failed task is stored and rethrown by the next call of wait. */
+class BackgroundTask
+{
+  private:
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::function<void()> task;
+    std::exception_ptr error;
+    bool busy;
+    bool stopping;
+    std::thread thread;
+    void run();
+
+  public:
+    BackgroundTask();
+    ~BackgroundTask();
+    void submit(std::function<void()>);
+    void wait();
+};
+
+#endif
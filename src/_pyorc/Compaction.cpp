@@ -0,0 +1,419 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <set>
+#include <sstream>
+
+#include "Compaction.h"
+#include "PyORCStream.h"
+#include "SearchArgument.h"
+#include "VectorBatch.h"
+
+RowFilter::RowFilter(py::object predicate,
+                     const orc::Type& type,
+                     py::dict convDict,
+                     py::object timezoneInfo)
+{
+    try {
+        root = buildNode(predicate.attr("values"), type, convDict, timezoneInfo);
+    } catch (py::error_already_set& err) {
+        if (err.matches(PyExc_AttributeError)) {
+            throw py::type_error("Invalid predicate: " +
+                                 py::cast<std::string>(py::repr(predicate)));
+        }
+        throw;
+    }
+    positions.resize(type.getSubtypeCount(), 0);
+}
+
+FilterNode
+RowFilter::buildNode(py::tuple predVals,
+                     const orc::Type& type,
+                     py::dict convDict,
+                     py::object timezoneInfo)
+{
+    FilterNode node;
+    node.opCode = py::cast<int>(predVals[0]);
+    switch (node.opCode) {
+        case 0: /* NOT */
+            node.children.push_back(
+              buildNode(predVals[1], type, convDict, timezoneInfo));
+            return node;
+        case 1: /* OR */
+        case 2: /* AND */
+            node.children.push_back(
+              buildNode(predVals[1], type, convDict, timezoneInfo));
+            node.children.push_back(
+              buildNode(predVals[2], type, convDict, timezoneInfo));
+            return node;
+        case 3: /* EQ */
+        case 4: /* LT */
+        case 5: /* LE */
+            break;
+        default:
+            throw py::type_error("Invalid operation on Literal in predicate");
+    }
+    py::object column = predVals[1];
+    py::object colName = column.attr("name");
+    py::object colIdx = column.attr("index");
+    bool found = false;
+    for (uint64_t i = 0; i < type.getSubtypeCount() && !found; ++i) {
+        if (!colName.is_none()) {
+            found = type.getFieldName(i) == py::cast<std::string>(colName);
+        } else if (!colIdx.is_none()) {
+            found = type.getSubtype(i)->getColumnId() == py::cast<uint64_t>(colIdx);
+        } else {
+            throw py::type_error("Either name or index parameter must be set");
+        }
+        if (found) {
+            node.field = i;
+        }
+    }
+    if (!found) {
+        throw py::value_error("Rows can be filtered only by top-level columns, " +
+                              py::cast<std::string>(py::repr(column)) +
+                              " is not one of them");
+    }
+    node.type = type.getSubtype(node.field);
+    py::object value = predVals[2];
+    node.nullLiteral = value.is_none();
+    if (node.nullLiteral) {
+        return node;
+    }
+    switch (static_cast<int64_t>(node.type->getKind())) {
+        case orc::BOOLEAN:
+            node.longValue = py::cast<bool>(value) ? 1 : 0;
+            break;
+        case orc::BYTE:
+        case orc::SHORT:
+        case orc::INT:
+        case orc::LONG:
+            node.longValue = py::cast<int64_t>(value);
+            break;
+        case orc::FLOAT:
+        case orc::DOUBLE:
+            node.doubleValue = py::cast<double>(value);
+            break;
+        case orc::CHAR:
+        case orc::VARCHAR:
+        case orc::STRING:
+            node.stringValue = py::cast<std::string>(value);
+            break;
+        case orc::DATE: {
+            py::object idx(py::int_(static_cast<int>(orc::TypeKind::DATE)));
+            node.longValue = py::cast<int64_t>(convDict[idx].attr("to_orc")(value));
+            break;
+        }
+        case orc::TIMESTAMP:
+        case orc::TIMESTAMP_INSTANT: {
+            py::object idx(py::int_(static_cast<int>(orc::TypeKind::TIMESTAMP)));
+            py::tuple res = convDict[idx].attr("to_orc")(value, timezoneInfo);
+            node.longValue = py::cast<int64_t>(res[0]);
+            node.nanoseconds = py::cast<int64_t>(res[1]);
+            break;
+        }
+        case orc::DECIMAL: {
+            /* The literal is scaled to the column, a non-integer result is
+               stored as its floor, flagged as fractional. */
+            py::module decimal = py::module::import("decimal");
+            py::object scaled =
+              decimal.attr("Decimal")(value).attr("scaleb")(node.type->getScale());
+            py::object floor = scaled.attr("to_integral_value")(
+              py::arg("rounding") = decimal.attr("ROUND_FLOOR"));
+            node.fractional = !floor.equal(scaled);
+            node.decimalValue =
+              orc::Int128(py::cast<std::string>(py::str(py::int_(floor))));
+            break;
+        }
+        default:
+            throw py::type_error("Unsupported type for ORC Literal in predicate");
+    }
+    return node;
+}
+
+void
+RowFilter::collectFields(const FilterNode& node, std::set<uint64_t>& fields) const
+{
+    if (node.opCode <= 2) {
+        for (const FilterNode& child : node.children) {
+            collectFields(child, fields);
+        }
+    } else {
+        fields.insert(node.field);
+    }
+}
+
+std::set<uint64_t>
+RowFilter::fields() const
+{
+    std::set<uint64_t> result;
+    collectFields(root, result);
+    return result;
+}
+
+void
+RowFilter::bind(const std::vector<uint64_t>& selected)
+{
+    for (uint64_t i = 0; i < selected.size(); ++i) {
+        positions[selected[i]] = i;
+    }
+}
+
+template <typename T>
+static int
+compareTo(const T& value, const T& literal)
+{
+    if (value < literal) {
+        return -1;
+    }
+    return literal < value ? 1 : 0;
+}
+
+Truth
+RowFilter::evaluate(const FilterNode& node,
+                    const orc::StructVectorBatch& batch,
+                    uint64_t row) const
+{
+    switch (node.opCode) {
+        case 0: { /* NOT */
+            Truth res = evaluate(node.children[0], batch, row);
+            if (res == Truth::Unknown) {
+                return res;
+            }
+            return res == Truth::True ? Truth::False : Truth::True;
+        }
+        case 1: { /* OR */
+            Truth left = evaluate(node.children[0], batch, row);
+            if (left == Truth::True) {
+                return left;
+            }
+            Truth right = evaluate(node.children[1], batch, row);
+            return right == Truth::True ? right : std::max(left, right);
+        }
+        case 2: { /* AND */
+            Truth left = evaluate(node.children[0], batch, row);
+            if (left == Truth::False) {
+                return left;
+            }
+            Truth right = evaluate(node.children[1], batch, row);
+            if (right == Truth::False) {
+                return right;
+            }
+            return std::max(left, right);
+        }
+        default:
+            break;
+    }
+    const orc::ColumnVectorBatch& col = *batch.fields[positions[node.field]];
+    if (node.nullLiteral || (col.hasNulls && !col.notNull[row])) {
+        return Truth::Unknown;
+    }
+    int cmp = 0;
+    switch (static_cast<int64_t>(node.type->getKind())) {
+        case orc::FLOAT:
+        case orc::DOUBLE: {
+            double value = static_cast<const orc::DoubleVectorBatch&>(col).data[row];
+            if (std::isnan(value) || std::isnan(node.doubleValue)) {
+                return Truth::Unknown;
+            }
+            cmp = compareTo(value, node.doubleValue);
+            break;
+        }
+        case orc::CHAR:
+        case orc::VARCHAR:
+        case orc::STRING: {
+            const auto& strBatch = static_cast<const orc::StringVectorBatch&>(col);
+            size_t length = static_cast<size_t>(strBatch.length[row]);
+            size_t litLength = node.stringValue.size();
+            cmp = std::memcmp(
+              strBatch.data[row], node.stringValue.data(), std::min(length, litLength));
+            if (cmp == 0) {
+                cmp = compareTo(length, litLength);
+            }
+            break;
+        }
+        case orc::TIMESTAMP:
+        case orc::TIMESTAMP_INSTANT: {
+            const auto& tsBatch = static_cast<const orc::TimestampVectorBatch&>(col);
+            cmp = compareTo(tsBatch.data[row], node.longValue);
+            if (cmp == 0) {
+                cmp = compareTo(tsBatch.nanoseconds[row], node.nanoseconds);
+            }
+            break;
+        }
+        case orc::DECIMAL: {
+            orc::Int128 value;
+            if (node.type->getPrecision() != 0 && node.type->getPrecision() <= 18) {
+                value = orc::Int128(
+                  static_cast<const orc::Decimal64VectorBatch&>(col).values[row]);
+            } else {
+                value = static_cast<const orc::Decimal128VectorBatch&>(col).values[row];
+            }
+            cmp = compareTo(value, node.decimalValue);
+            if (cmp == 0 && node.fractional) {
+                cmp = -1;
+            }
+            break;
+        }
+        default:
+            cmp = compareTo(static_cast<const orc::LongVectorBatch&>(col).data[row],
+                            node.longValue);
+            break;
+    }
+    bool res;
+    if (node.opCode == 3) {
+        res = cmp == 0;
+    } else if (node.opCode == 4) {
+        res = cmp < 0;
+    } else {
+        res = cmp <= 0;
+    }
+    return res ? Truth::True : Truth::False;
+}
+
+bool
+RowFilter::matches(const orc::StructVectorBatch& batch, uint64_t row) const
+{
+    return evaluate(root, batch, row) == Truth::True;
+}
+
+static void
+copyUserMetadata(const orc::Reader& reader,
+                 Writer& output,
+                 std::set<std::string>& metadataKeys)
+{
+    for (const std::string& key : reader.getMetadataKeys()) {
+        if (metadataKeys.insert(key).second) {
+            output.addUserMetadata(py::str(key),
+                                   py::bytes(reader.getMetadataValue(key)));
+        }
+    }
+}
+
+uint64_t
+concatFiles(py::list inputs, Writer& output, uint64_t batchSize)
+{
+    const orc::Type& type = output.schemaType();
+    std::set<std::string> metadataKeys;
+    uint64_t rows = 0;
+    for (size_t idx = 0; idx < inputs.size(); ++idx) {
+        std::unique_ptr<orc::Reader> reader = orc::createReader(
+          std::unique_ptr<orc::InputStream>(new PyORCInputStream(inputs[idx])),
+          orc::ReaderOptions());
+        if (reader->getType().toString() != type.toString()) {
+            std::stringstream errmsg;
+            errmsg << "The schema of input " << idx << " ("
+                   << reader->getType().toString()
+                   << ") does not match the output schema";
+            throw py::value_error(errmsg.str());
+        }
+        copyUserMetadata(*reader, output, metadataKeys);
+        std::unique_ptr<orc::RowReader> rowReader = reader->createRowReader();
+        std::unique_ptr<orc::ColumnVectorBatch> batch =
+          rowReader->createRowBatch(batchSize);
+        while (rowReader->next(*batch)) {
+            output.addNativeBatch(*batch);
+            rows += batch->numElements;
+        }
+    }
+    return rows;
+}
+
+uint64_t
+rewriteFile(py::object input,
+            Writer& output,
+            std::vector<uint64_t> columns,
+            py::object predicate,
+            py::object timezoneInfo,
+            uint64_t batchSize)
+{
+    std::unique_ptr<orc::Reader> reader = orc::createReader(
+      std::unique_ptr<orc::InputStream>(new PyORCInputStream(input)),
+      orc::ReaderOptions());
+    const orc::Type& type = reader->getType();
+    if (type.getKind() != orc::TypeKind::STRUCT) {
+        throw py::type_error("Rewriting requires a struct schema");
+    }
+    if (columns.empty()) {
+        for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+            columns.push_back(i);
+        }
+    }
+    /* The fields are written in the order of the file schema. */
+    std::sort(columns.begin(), columns.end());
+    columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+    for (uint64_t column : columns) {
+        if (column >= type.getSubtypeCount()) {
+            throw py::index_error("column index out of range");
+        }
+    }
+    std::set<std::string> metadataKeys;
+    copyUserMetadata(*reader, output, metadataKeys);
+
+    orc::RowReaderOptions rowReaderOpts;
+    if (!timezoneInfo.is_none()) {
+        std::string tzKey = py::cast<std::string>(timezoneInfo.attr("key"));
+        rowReaderOpts = rowReaderOpts.setTimezoneName(tzKey);
+    }
+    std::unique_ptr<RowFilter> filter;
+    std::set<uint64_t> selected(columns.begin(), columns.end());
+    if (!predicate.is_none()) {
+        py::dict convDict(
+          py::module::import("pyorc.converters").attr("DEFAULT_CONVERTERS"));
+        filter = std::unique_ptr<RowFilter>(
+          new RowFilter(predicate, type, convDict, timezoneInfo));
+        /* Skip the stripes and row groups by their statistics first. */
+        rowReaderOpts = rowReaderOpts.searchArgument(
+          createSearchArgument(predicate, convDict, timezoneInfo));
+        std::set<uint64_t> filterFields = filter->fields();
+        selected.insert(filterFields.begin(), filterFields.end());
+    }
+    std::vector<uint64_t> readFields(selected.begin(), selected.end());
+    rowReaderOpts = rowReaderOpts.include(
+      std::list<uint64_t>(readFields.begin(), readFields.end()));
+    std::unique_ptr<orc::RowReader> rowReader = reader->createRowReader(rowReaderOpts);
+    const orc::Type& readType = rowReader->getSelectedType();
+    const orc::Type& outType = output.schemaType();
+    /* The position of the written fields in the read batch, that might
+       contain further fields for the filter. */
+    std::vector<uint64_t> outFields;
+    for (uint64_t column : columns) {
+        outFields.push_back(static_cast<uint64_t>(
+          std::lower_bound(readFields.begin(), readFields.end(), column) -
+          readFields.begin()));
+    }
+    bool compatible = outType.getKind() == orc::TypeKind::STRUCT &&
+                      outType.getSubtypeCount() == outFields.size();
+    for (uint64_t i = 0; compatible && i < outFields.size(); ++i) {
+        compatible = outType.getFieldName(i) == readType.getFieldName(outFields[i]) &&
+                     outType.getSubtype(i)->toString() ==
+                       readType.getSubtype(outFields[i])->toString();
+    }
+    if (!compatible) {
+        throw py::value_error("The schema of the writer does not match the columns");
+    }
+    bool projected = readFields.size() != columns.size();
+    if (filter) {
+        filter->bind(readFields);
+    }
+    std::unique_ptr<orc::ColumnVectorBatch> batch =
+      rowReader->createRowBatch(batchSize);
+    uint64_t rows = 0;
+    while (rowReader->next(*batch)) {
+        if (!filter && !projected) {
+            output.addNativeBatch(*batch);
+            rows += batch->numElements;
+            continue;
+        }
+        const auto& structBatch = static_cast<const orc::StructVectorBatch&>(*batch);
+        for (uint64_t row = 0; row < batch->numElements; ++row) {
+            if (!filter || filter->matches(structBatch, row)) {
+                output.appendRow(*batch, row, outFields);
+                ++rows;
+            }
+        }
+        /* The next read overwrites the batch. */
+        output.flushRows();
+    }
+    return rows;
+}
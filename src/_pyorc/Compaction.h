@@ -0,0 +1,78 @@
+#ifndef COMPACTION_H
+#define COMPACTION_H
+
+#include <set>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "Writer.h"
+
+namespace py = pybind11;
+
+enum class Truth
+{
+    False,
+    True,
+    Unknown
+};
+
+/* A node of a predicate resolved against the top-level fields of a file
+   schema. The comparisons hold the literal in the representation of the
+   column's batch. */
+struct FilterNode
+{
+    int opCode = 0;
+    std::vector<FilterNode> children;
+    uint64_t field = 0;
+    const orc::Type* type = nullptr;
+    bool nullLiteral = false;
+    int64_t longValue = 0;
+    int64_t nanoseconds = 0;
+    double doubleValue = 0.0;
+    std::string stringValue;
+    orc::Int128 decimalValue;
+    bool fractional = false;
+};
+
+/* Evaluates a Predicate for the rows of a struct batch with SQL semantics:
+   a comparison with a null is unknown, and only the rows where the
+   predicate is true match. */
+class RowFilter
+{
+  private:
+    FilterNode root;
+    std::vector<uint64_t> positions;
+    FilterNode buildNode(py::tuple, const orc::Type&, py::dict, py::object);
+    void collectFields(const FilterNode&, std::set<uint64_t>&) const;
+    Truth evaluate(const FilterNode&, const orc::StructVectorBatch&, uint64_t) const;
+
+  public:
+    RowFilter(py::object, const orc::Type&, py::dict, py::object);
+    /* The top-level fields of the file that the predicate uses. */
+    std::set<uint64_t> fields() const;
+    /* Sets the selected top-level fields of the batches to evaluate. */
+    void bind(const std::vector<uint64_t>&);
+    bool matches(const orc::StructVectorBatch&, uint64_t) const;
+};
+
+/* Appends the rows of ORC files (binary file-like objects) with the same
+   schema to the writer. The decoded batches are passed to the ORC writer
+   without converting them to Python objects. The user metadata of the
+   inputs are copied too, the first value is kept for duplicated keys.
+   Returns the number of written rows. */
+uint64_t
+concatFiles(py::list, Writer&, uint64_t = 1024);
+
+/* Writes the rows of an ORC file to the writer natively, projected to the
+   top-level fields (all of them if empty) and filtered by the predicate.
+   Returns the number of written rows. */
+uint64_t
+rewriteFile(py::object,
+            Writer&,
+            std::vector<uint64_t>,
+            py::object,
+            py::object,
+            uint64_t = 1024);
+
+#endif
@@ -1,16 +1,69 @@
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 
+#include <datetime.h>
+
 #include "Converter.h"
+#include "VectorBatch.h"
+#include "verguard.h"
+
+/* Read access to the values of integer vectors, that are decoded into
+   narrower items than int64_t with tight numeric vectors. */
+class IntegerValues
+{
+  private:
+    const void* data = nullptr;
+    uint8_t width = 0;
+
+  public:
+    void reset(const orc::ColumnVectorBatch& batch);
+    const char* raw() const { return static_cast<const char*>(data); }
+    size_t itemSize() const { return width; }
+    int64_t operator[](uint64_t idx) const
+    {
+        switch (width) {
+            case 1:
+                return static_cast<const int8_t*>(data)[idx];
+            case 2:
+                return static_cast<const int16_t*>(data)[idx];
+            case 4:
+                return static_cast<const int32_t*>(data)[idx];
+            default:
+                return static_cast<const int64_t*>(data)[idx];
+        }
+    }
+};
+
+/* Read access to the values of floating point vectors, that are decoded
+   into floats for FLOAT columns with tight numeric vectors. */
+class FloatingValues
+{
+  private:
+    const void* data = nullptr;
+    bool single = false;
+
+  public:
+    void reset(const orc::ColumnVectorBatch& batch);
+    const char* raw() const { return static_cast<const char*>(data); }
+    size_t itemSize() const { return single ? sizeof(float) : sizeof(double); }
+    double operator[](uint64_t idx) const
+    {
+        if (single) {
+            return static_cast<const float*>(data)[idx];
+        }
+        return static_cast<const double*>(data)[idx];
+    }
+};
 
 class BoolConverter : public Converter
 {
   private:
-    const int64_t* data;
+    IntegerValues data;
 
   public:
     BoolConverter(py::object nv)
       : Converter(nv)
-      , data(nullptr)
     {}
     ~BoolConverter() override {}
     py::object toPython(uint64_t rowId) override;
@@ -21,12 +74,11 @@ class BoolConverter : public Converter
 class LongConverter : public Converter
 {
   private:
-    const int64_t* data;
+    IntegerValues data;
 
   public:
     LongConverter(py::object nv)
       : Converter(nv)
-      , data(nullptr)
     {}
     ~LongConverter() override {}
     py::object toPython(uint64_t rowId) override;
@@ -37,12 +89,11 @@ class LongConverter : public Converter
 class DoubleConverter : public Converter
 {
   private:
-    const double* data;
+    FloatingValues data;
 
   public:
     DoubleConverter(py::object nv)
       : Converter(nv)
-      , data(nullptr)
     {}
     ~DoubleConverter() override{};
     py::object toPython(uint64_t rowId) override;
@@ -55,13 +106,14 @@ class StringConverter : public Converter
   private:
     const char* const* data;
     const int64_t* length;
-    std::vector<py::object> buffer;
+    StringArena arena;
 
   public:
-    StringConverter(py::object nv)
+    StringConverter(py::object nv, orc::MemoryPool* pool)
       : Converter(nv)
       , data(nullptr)
       , length(nullptr)
+      , arena(pool)
     {}
     ~StringConverter() override{};
     py::object toPython(uint64_t rowId) override;
@@ -75,13 +127,14 @@ class BinaryConverter : public Converter
   private:
     const char* const* data;
     const int64_t* length;
-    std::vector<py::object> buffer;
+    StringArena arena;
 
   public:
-    BinaryConverter(py::object nv)
+    BinaryConverter(py::object nv, orc::MemoryPool* pool)
       : Converter(nv)
       , data(nullptr)
       , length(nullptr)
+      , arena(pool)
     {}
     ~BinaryConverter() override{};
     py::object toPython(uint64_t rowId) override;
@@ -98,6 +151,7 @@ class TimestampConverter : public Converter
     py::object to_orc;
     py::object from_orc;
     py::object timeZoneInfo;
+    bool nativeWrite;
 
   public:
     TimestampConverter(py::dict conv, py::object tzone, py::object nv);
@@ -113,6 +167,7 @@ class DateConverter : public Converter
     const int64_t* data;
     py::object to_orc;
     py::object from_orc;
+    bool nativeWrite;
 
   public:
     DateConverter(py::dict conv, py::object nv);
@@ -130,6 +185,7 @@ class Decimal64Converter : public Converter
     int32_t scale;
     py::object to_orc;
     py::object from_orc;
+    py::object decimalType;
 
   public:
     Decimal64Converter(uint64_t prec_, uint64_t scale_, py::dict conv, py::object nv);
@@ -147,6 +203,7 @@ class Decimal128Converter : public Converter
     int32_t scale;
     py::object to_orc;
     py::object from_orc;
+    py::object decimalType;
 
   public:
     Decimal128Converter(uint64_t prec_, uint64_t scale_, py::dict conv, py::object nv);
@@ -161,13 +218,23 @@ class ListConverter : public Converter
   private:
     const int64_t* offsets;
     std::unique_ptr<Converter> elementConverter;
+    /* Set when numeric elements are returned as array.array. */
+    py::object arrayType = py::none();
+    bool floatingElements = false;
+    const char* typecode = nullptr;
+    const char* elementData = nullptr;
+    const char* elementNotNull = nullptr;
+    size_t itemSize = 0;
+    py::object toArray(int64_t begin, int64_t end) const;
 
   public:
     ListConverter(const orc::Type& type,
                   unsigned int structKind,
                   py::dict conv,
                   py::object tzone,
-                  py::object nv);
+                  py::object nv,
+                  bool listAsArray,
+                  orc::MemoryPool* pool);
     virtual ~ListConverter() override{};
     py::object toPython(uint64_t rowId) override;
     void reset(const orc::ColumnVectorBatch& batch) override;
@@ -187,7 +254,9 @@ class MapConverter : public Converter
                  unsigned int structKind,
                  py::dict conv,
                  py::object tzone,
-                 py::object nv);
+                 py::object nv,
+                 bool listAsArray,
+                 orc::MemoryPool* pool);
     virtual ~MapConverter() override{};
     py::object toPython(uint64_t rowId) override;
     void reset(const orc::ColumnVectorBatch& batch) override;
@@ -208,7 +277,9 @@ class UnionConverter : public Converter
                    unsigned int structKind,
                    py::dict conv,
                    py::object tzone,
-                   py::object nv);
+                   py::object nv,
+                   bool listAsArray,
+                   orc::MemoryPool* pool);
     virtual ~UnionConverter() override;
     py::object toPython(uint64_t rowId) override;
     void reset(const orc::ColumnVectorBatch& batch) override;
@@ -228,10 +299,13 @@ class StructConverter : public Converter
                     unsigned int kind_,
                     py::dict conv,
                     py::object tzone,
-                    py::object nv);
+                    py::object nv,
+                    bool listAsArray,
+                    orc::MemoryPool* pool);
     virtual ~StructConverter() override;
     py::object toPython(uint64_t rowId) override;
     void reset(const orc::ColumnVectorBatch& batch) override;
+    void appendColumns(py::dict columns, uint64_t begin, uint64_t end) override;
     void write(orc::ColumnVectorBatch* batch, uint64_t rowId, py::object elem) override;
     void clear() override;
 };
@@ -241,10 +315,12 @@ createConverter(const orc::Type* type,
                 unsigned int structKind,
                 py::dict conv,
                 py::object tzone,
-                py::object nullValue)
+                py::object nullValue,
+                bool listAsArray,
+                orc::MemoryPool* pool)
 {
     Converter* result = nullptr;
-    if (structKind > 1) {
+    if (structKind > 2) {
         throw py::value_error("Invalid struct kind");
     }
     if (type == nullptr) {
@@ -267,23 +343,26 @@ createConverter(const orc::Type* type,
             case orc::STRING:
             case orc::VARCHAR:
             case orc::CHAR:
-                result = new StringConverter(nullValue);
+                result = new StringConverter(nullValue, pool);
                 break;
             case orc::BINARY:
-                result = new BinaryConverter(nullValue);
+                result = new BinaryConverter(nullValue, pool);
                 break;
             case orc::TIMESTAMP:
             case orc::TIMESTAMP_INSTANT:
                 result = new TimestampConverter(conv, tzone, nullValue);
                 break;
             case orc::LIST:
-                result = new ListConverter(*type, structKind, conv, tzone, nullValue);
+                result = new ListConverter(
+                  *type, structKind, conv, tzone, nullValue, listAsArray, pool);
                 break;
             case orc::MAP:
-                result = new MapConverter(*type, structKind, conv, tzone, nullValue);
+                result = new MapConverter(
+                  *type, structKind, conv, tzone, nullValue, listAsArray, pool);
                 break;
             case orc::STRUCT:
-                result = new StructConverter(*type, structKind, conv, tzone, nullValue);
+                result = new StructConverter(
+                  *type, structKind, conv, tzone, nullValue, listAsArray, pool);
                 break;
             case orc::DECIMAL:
                 if (type->getPrecision() == 0 || type->getPrecision() > 18) {
@@ -298,7 +377,8 @@ createConverter(const orc::Type* type,
                 result = new DateConverter(conv, nullValue);
                 break;
             case orc::UNION:
-                result = new UnionConverter(*type, structKind, conv, tzone, nullValue);
+                result = new UnionConverter(
+                  *type, structKind, conv, tzone, nullValue, listAsArray, pool);
                 break;
             default:
                 throw py::value_error("unknown batch type");
@@ -318,11 +398,55 @@ Converter::reset(const orc::ColumnVectorBatch& batch)
     }
 }
 
+void
+IntegerValues::reset(const orc::ColumnVectorBatch& batch)
+{
+#if ORC_VERSION_AT_LEAST(1, 9, 0)
+    if (auto* byteBatch = dynamic_cast<const orc::ByteVectorBatch*>(&batch)) {
+        data = byteBatch->data.data();
+        width = 1;
+        return;
+    }
+    if (auto* shortBatch = dynamic_cast<const orc::ShortVectorBatch*>(&batch)) {
+        data = shortBatch->data.data();
+        width = 2;
+        return;
+    }
+    if (auto* intBatch = dynamic_cast<const orc::IntVectorBatch*>(&batch)) {
+        data = intBatch->data.data();
+        width = 4;
+        return;
+    }
+#endif
+    data = dynamic_cast<const orc::LongVectorBatch&>(batch).data.data();
+    width = 8;
+}
+
+void
+FloatingValues::reset(const orc::ColumnVectorBatch& batch)
+{
+#if ORC_VERSION_AT_LEAST(1, 9, 0)
+    if (auto* floatBatch = dynamic_cast<const orc::FloatVectorBatch*>(&batch)) {
+        data = floatBatch->data.data();
+        single = true;
+        return;
+    }
+#endif
+    data = dynamic_cast<const orc::DoubleVectorBatch&>(batch).data.data();
+    single = false;
+}
+
+void
+Converter::appendColumns(py::dict, uint64_t, uint64_t)
+{
+    throw py::type_error("Only structs can be converted to columns");
+}
+
 void
 BoolConverter::reset(const orc::ColumnVectorBatch& batch)
 {
     Converter::reset(batch);
-    data = dynamic_cast<const orc::LongVectorBatch&>(batch).data.data();
+    data.reset(batch);
 }
 
 py::object
@@ -338,7 +462,7 @@ BoolConverter::toPython(uint64_t rowId)
 void
 BoolConverter::write(orc::ColumnVectorBatch* batch, uint64_t rowId, py::object elem)
 {
-    auto* longBatch = dynamic_cast<orc::LongVectorBatch*>(batch);
+    auto* longBatch = static_cast<orc::LongVectorBatch*>(batch);
     if (elem.is(nullValue)) {
         longBatch->hasNulls = true;
         longBatch->notNull[rowId] = 0;
@@ -360,7 +484,7 @@ void
 LongConverter::reset(const orc::ColumnVectorBatch& batch)
 {
     Converter::reset(batch);
-    data = dynamic_cast<const orc::LongVectorBatch&>(batch).data.data();
+    data.reset(batch);
 }
 
 py::object
@@ -376,7 +500,7 @@ LongConverter::toPython(uint64_t rowId)
 void
 LongConverter::write(orc::ColumnVectorBatch* batch, uint64_t rowId, py::object elem)
 {
-    auto* longBatch = dynamic_cast<orc::LongVectorBatch*>(batch);
+    auto* longBatch = static_cast<orc::LongVectorBatch*>(batch);
     if (elem.is(nullValue)) {
         longBatch->hasNulls = true;
         longBatch->notNull[rowId] = 0;
@@ -398,7 +522,7 @@ void
 DoubleConverter::reset(const orc::ColumnVectorBatch& batch)
 {
     Converter::reset(batch);
-    data = dynamic_cast<const orc::DoubleVectorBatch&>(batch).data.data();
+    data.reset(batch);
 }
 
 py::object
@@ -414,7 +538,7 @@ DoubleConverter::toPython(uint64_t rowId)
 void
 DoubleConverter::write(orc::ColumnVectorBatch* batch, uint64_t rowId, py::object elem)
 {
-    auto* doubleBatch = dynamic_cast<orc::DoubleVectorBatch*>(batch);
+    auto* doubleBatch = static_cast<orc::DoubleVectorBatch*>(batch);
     if (elem.is(nullValue)) {
         doubleBatch->hasNulls = true;
         doubleBatch->notNull[rowId] = 0;
@@ -454,7 +578,7 @@ StringConverter::toPython(uint64_t rowId)
 void
 StringConverter::write(orc::ColumnVectorBatch* batch, uint64_t rowId, py::object elem)
 {
-    auto* strBatch = dynamic_cast<orc::StringVectorBatch*>(batch);
+    auto* strBatch = static_cast<orc::StringVectorBatch*>(batch);
     if (elem.is(nullValue)) {
         strBatch->hasNulls = true;
         strBatch->notNull[rowId] = 0;
@@ -472,8 +596,7 @@ StringConverter::write(orc::ColumnVectorBatch* batch, uint64_t rowId, py::object
                 throw py::error_already_set();
             }
         }
-        buffer.push_back(elem);
-        strBatch->data[rowId] = const_cast<char*>(src);
+        strBatch->data[rowId] = arena.copy(src, static_cast<size_t>(length));
         strBatch->length[rowId] = static_cast<int64_t>(length);
         strBatch->notNull[rowId] = 1;
     }
@@ -483,7 +606,7 @@ StringConverter::write(orc::ColumnVectorBatch* batch, uint64_t rowId, py::object
 void
 StringConverter::clear()
 {
-    buffer.clear();
+    arena.clear();
 }
 
 void
@@ -509,7 +632,7 @@ void
 BinaryConverter::write(orc::ColumnVectorBatch* batch, uint64_t rowId, py::object elem)
 {
     char* src = nullptr;
-    auto* bytesBatch = dynamic_cast<orc::StringVectorBatch*>(batch);
+    auto* bytesBatch = static_cast<orc::StringVectorBatch*>(batch);
     if (elem.is(nullValue)) {
         bytesBatch->hasNulls = true;
         bytesBatch->notNull[rowId] = 0;
@@ -527,8 +650,7 @@ BinaryConverter::write(orc::ColumnVectorBatch* batch, uint64_t rowId, py::object
                 throw py::error_already_set();
             }
         }
-        buffer.push_back(elem);
-        bytesBatch->data[rowId] = src;
+        bytesBatch->data[rowId] = arena.copy(src, static_cast<size_t>(length));
         bytesBatch->length[rowId] = static_cast<int64_t>(length);
         bytesBatch->notNull[rowId] = 1;
     }
@@ -538,7 +660,97 @@ BinaryConverter::write(orc::ColumnVectorBatch* batch, uint64_t rowId, py::object
 void
 BinaryConverter::clear()
 {
-    buffer.clear();
+    arena.clear();
+}
+
+/* Whether the converter of the type kind is the default one of
+   pyorc.converters, that can be replaced with a native conversion. */
+static bool
+isDefaultConverter(py::dict conv, orc::TypeKind kind, const char* name)
+{
+    py::object idx(py::int_(static_cast<int>(kind)));
+    py::object defaultConv = py::module::import("pyorc.converters").attr(name);
+    return conv[idx].is(defaultConv);
+}
+
+/* The number of days since 1970-01-01 of a proleptic Gregorian date. */
+static int64_t
+daysFromCivil(int64_t year, int64_t month, int64_t day)
+{
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const int64_t yoe = year - era * 400;
+    const int64_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+/* Converts an aware datetime the same way as the default converter's
+   to_orc. Returns false if the object has to be converted in Python:
+   subclasses, naive datetimes (those are interpreted in the local time
+   zone) and UTC offsets with microseconds. */
+static bool
+datetimeToOrc(py::handle obj, int64_t& seconds, int64_t& nanoseconds)
+{
+    if (!PyDateTime_CheckExact(obj.ptr())) {
+        return false;
+    }
+    py::object offset = obj.attr("utcoffset")();
+    if (offset.is_none() || !PyDelta_Check(offset.ptr()) ||
+        PyDateTime_DELTA_GET_MICROSECONDS(offset.ptr()) != 0) {
+        return false;
+    }
+    PyObject* dt = obj.ptr();
+    int64_t days = daysFromCivil(PyDateTime_GET_YEAR(dt),
+                                 PyDateTime_GET_MONTH(dt),
+                                 PyDateTime_GET_DAY(dt));
+    seconds = days * 86400 + PyDateTime_DATE_GET_HOUR(dt) * 3600 +
+              PyDateTime_DATE_GET_MINUTE(dt) * 60 + PyDateTime_DATE_GET_SECOND(dt) -
+              (static_cast<int64_t>(PyDateTime_DELTA_GET_DAYS(offset.ptr())) * 86400 +
+               PyDateTime_DELTA_GET_SECONDS(offset.ptr()));
+    nanoseconds = static_cast<int64_t>(PyDateTime_DATE_GET_MICROSECOND(dt)) * 1000;
+    return true;
+}
+
+/* Collects the digits of a Decimal object as an integer adjusted to the
+   scale, the same way as the default converter's to_orc. Returns false if
+   the value has to be converted in Python: NaN and infinity, values that
+   need rounding or have more digits than the precision. */
+template <typename T>
+static bool
+decimalToOrc(py::handle obj,
+             const py::object& decimalType,
+             uint64_t prec,
+             int32_t scale,
+             T& result)
+{
+    if (prec == 0 || !obj.get_type().is(decimalType)) {
+        return false;
+    }
+    py::tuple parts = obj.attr("as_tuple")();
+    if (!py::isinstance<py::int_>(parts[2])) {
+        return false;
+    }
+    int64_t exponent = py::cast<int64_t>(parts[2]);
+    py::tuple digits = parts[1];
+    if (exponent + scale < 0 ||
+        static_cast<int64_t>(digits.size()) + exponent + scale >
+          static_cast<int64_t>(prec)) {
+        return false;
+    }
+    T value(0);
+    for (auto digit : digits) {
+        value *= 10;
+        value += py::cast<int64_t>(digit);
+    }
+    for (int64_t i = 0; i < exponent + scale; ++i) {
+        value *= 10;
+    }
+    if (py::cast<int64_t>(parts[0]) == 1) {
+        value *= -1;
+    }
+    result = value;
+    return true;
 }
 
 TimestampConverter::TimestampConverter(py::dict conv, py::object tzone, py::object nv)
@@ -550,6 +762,13 @@ TimestampConverter::TimestampConverter(py::dict conv, py::object tzone, py::obje
     timeZoneInfo = tzone;
     from_orc = conv[idx].attr("from_orc");
     to_orc = conv[idx].attr("to_orc");
+    nativeWrite = isDefaultConverter(conv, orc::TIMESTAMP, "TimestampConverter");
+    if (PyDateTimeAPI == nullptr) {
+        PyDateTime_IMPORT;
+        if (PyDateTimeAPI == nullptr) {
+            throw py::error_already_set();
+        }
+    }
 }
 
 void
@@ -576,10 +795,13 @@ TimestampConverter::write(orc::ColumnVectorBatch* batch,
                           uint64_t rowId,
                           py::object elem)
 {
-    auto* tsBatch = dynamic_cast<orc::TimestampVectorBatch*>(batch);
+    auto* tsBatch = static_cast<orc::TimestampVectorBatch*>(batch);
     if (elem.is(nullValue)) {
         tsBatch->hasNulls = true;
         tsBatch->notNull[rowId] = 0;
+    } else if (nativeWrite &&
+               datetimeToOrc(elem, tsBatch->data[rowId], tsBatch->nanoseconds[rowId])) {
+        tsBatch->notNull[rowId] = 1;
     } else {
         try {
             py::tuple res = to_orc(elem, timeZoneInfo);
@@ -608,6 +830,13 @@ DateConverter::DateConverter(py::dict conv, py::object nv)
     py::object idx(py::int_(static_cast<int>(orc::DATE)));
     from_orc = conv[idx].attr("from_orc");
     to_orc = conv[idx].attr("to_orc");
+    nativeWrite = isDefaultConverter(conv, orc::DATE, "DateConverter");
+    if (PyDateTimeAPI == nullptr) {
+        PyDateTime_IMPORT;
+        if (PyDateTimeAPI == nullptr) {
+            throw py::error_already_set();
+        }
+    }
 }
 
 void
@@ -630,10 +859,15 @@ DateConverter::toPython(uint64_t rowId)
 void
 DateConverter::write(orc::ColumnVectorBatch* batch, uint64_t rowId, py::object elem)
 {
-    auto* dBatch = dynamic_cast<orc::LongVectorBatch*>(batch);
+    auto* dBatch = static_cast<orc::LongVectorBatch*>(batch);
     if (elem.is(nullValue)) {
         dBatch->hasNulls = true;
         dBatch->notNull[rowId] = 0;
+    } else if (nativeWrite && PyDate_CheckExact(elem.ptr())) {
+        dBatch->data[rowId] = daysFromCivil(PyDateTime_GET_YEAR(elem.ptr()),
+                                            PyDateTime_GET_MONTH(elem.ptr()),
+                                            PyDateTime_GET_DAY(elem.ptr()));
+        dBatch->notNull[rowId] = 1;
     } else {
         dBatch->data[rowId] = py::cast<int64_t>(to_orc(elem));
         dBatch->notNull[rowId] = 1;
@@ -653,6 +887,9 @@ Decimal64Converter::Decimal64Converter(uint64_t prec_,
     py::object idx(py::int_(static_cast<int>(orc::DECIMAL)));
     from_orc = conv[idx].attr("from_orc");
     to_orc = conv[idx].attr("to_orc");
+    if (isDefaultConverter(conv, orc::DECIMAL, "DecimalConverter")) {
+        decimalType = py::module::import("decimal").attr("Decimal");
+    }
 }
 
 void
@@ -709,12 +946,15 @@ Decimal64Converter::write(orc::ColumnVectorBatch* batch,
                           uint64_t rowId,
                           py::object elem)
 {
-    auto* decBatch = dynamic_cast<orc::Decimal64VectorBatch*>(batch);
+    auto* decBatch = static_cast<orc::Decimal64VectorBatch*>(batch);
     decBatch->precision = prec;
     decBatch->scale = scale;
     if (elem.is(nullValue)) {
         decBatch->hasNulls = true;
         decBatch->notNull[rowId] = 0;
+    } else if (decimalType &&
+               decimalToOrc(elem, decimalType, prec, scale, decBatch->values[rowId])) {
+        decBatch->notNull[rowId] = 1;
     } else {
         py::object value = to_orc(decBatch->precision, decBatch->scale, elem);
         try {
@@ -742,6 +982,9 @@ Decimal128Converter::Decimal128Converter(uint64_t prec_,
     py::object idx(py::int_(static_cast<int>(orc::DECIMAL)));
     from_orc = conv[idx].attr("from_orc");
     to_orc = conv[idx].attr("to_orc");
+    if (isDefaultConverter(conv, orc::DECIMAL, "DecimalConverter")) {
+        decimalType = py::module::import("decimal").attr("Decimal");
+    }
 }
 
 void
@@ -768,12 +1011,15 @@ Decimal128Converter::write(orc::ColumnVectorBatch* batch,
                            uint64_t rowId,
                            py::object elem)
 {
-    auto* decBatch = dynamic_cast<orc::Decimal128VectorBatch*>(batch);
+    auto* decBatch = static_cast<orc::Decimal128VectorBatch*>(batch);
     decBatch->precision = prec;
     decBatch->scale = scale;
     if (elem.is(nullValue)) {
         decBatch->hasNulls = true;
         decBatch->notNull[rowId] = 0;
+    } else if (decimalType &&
+               decimalToOrc(elem, decimalType, prec, scale, decBatch->values[rowId])) {
+        decBatch->notNull[rowId] = 1;
     } else {
         py::object value = to_orc(decBatch->precision, decBatch->scale, elem);
         try {
@@ -790,15 +1036,55 @@ Decimal128Converter::write(orc::ColumnVectorBatch* batch,
     decBatch->numElements = rowId + 1;
 }
 
+/* Makes room for the needed number of elements in the child batch of a list
+   or map. After the first few rows of the batch the size of the whole batch
+   is estimated from them, to avoid repeated resizing and copying. */
+static void
+reserveChildren(orc::ColumnVectorBatch* children,
+                uint64_t rows,
+                uint64_t rowId,
+                uint64_t needed)
+{
+    if (children->capacity >= needed) {
+        return;
+    }
+    uint64_t size = 2 * needed;
+    if (rowId >= 16 && rows > rowId) {
+        uint64_t estimate = needed / (rowId + 1) * rows;
+        size = std::max(size, estimate + estimate / 8);
+    }
+    children->resize(size);
+}
+
 ListConverter::ListConverter(const orc::Type& type,
                              unsigned int structKind,
                              py::dict conv,
                              py::object tzone,
-                             py::object nv)
+                             py::object nv,
+                             bool listAsArray,
+                             orc::MemoryPool* pool)
   : Converter(nv)
   , offsets(nullptr)
 {
-    elementConverter = createConverter(type.getSubtype(0), structKind, conv, tzone, nv);
+    elementConverter = createConverter(
+      type.getSubtype(0), structKind, conv, tzone, nv, listAsArray, pool);
+    if (listAsArray) {
+        switch (static_cast<int64_t>(type.getSubtype(0)->getKind())) {
+            case orc::FLOAT:
+            case orc::DOUBLE:
+                floatingElements = true;
+                arrayType = py::module::import("array").attr("array");
+                break;
+            case orc::BYTE:
+            case orc::SHORT:
+            case orc::INT:
+            case orc::LONG:
+                arrayType = py::module::import("array").attr("array");
+                break;
+            default:
+                break;
+        }
+    }
 }
 
 void
@@ -808,6 +1094,56 @@ ListConverter::reset(const orc::ColumnVectorBatch& batch)
     const auto& listBatch = dynamic_cast<const orc::ListVectorBatch&>(batch);
     offsets = listBatch.offsets.data();
     elementConverter->reset(*listBatch.elements);
+    if (!arrayType.is_none()) {
+        const orc::ColumnVectorBatch& elements = *listBatch.elements;
+        elementNotNull = elements.hasNulls ? elements.notNull.data() : nullptr;
+        /* The typecode follows the width of the decoded vector, that
+           depends on the tight_numeric_vector option of the reader. */
+        if (floatingElements) {
+            FloatingValues values;
+            values.reset(elements);
+            elementData = values.raw();
+            itemSize = values.itemSize();
+            typecode = itemSize == sizeof(float) ? "f" : "d";
+        } else {
+            IntegerValues values;
+            values.reset(elements);
+            elementData = values.raw();
+            itemSize = values.itemSize();
+            switch (itemSize) {
+                case 1:
+                    typecode = "b";
+                    break;
+                case 2:
+                    typecode = "h";
+                    break;
+                case 4:
+                    typecode = "i";
+                    break;
+                default:
+                    typecode = "q";
+            }
+        }
+    }
+}
+
+py::object
+ListConverter::toArray(int64_t begin, int64_t end) const
+{
+    py::object result = arrayType(typecode);
+    if (end > begin) {
+        /* Copy the items straight from the vector batch, through a view
+           that does not outlive this call. */
+        py::object view = py::reinterpret_steal<py::object>(
+          PyMemoryView_FromMemory(const_cast<char*>(elementData + begin * itemSize),
+                                  (end - begin) * itemSize,
+                                  PyBUF_READ));
+        if (!view) {
+            throw py::error_already_set();
+        }
+        result.attr("frombytes")(view);
+    }
+    return result;
 }
 
 py::object
@@ -816,8 +1152,18 @@ ListConverter::toPython(uint64_t rowId)
     if (hasNulls && !notNull[rowId]) {
         return nullValue;
     } else {
+        int64_t begin = offsets[rowId];
+        int64_t end = offsets[rowId + 1];
+        /* An array cannot hold nulls, such lists are returned as list. */
+        if (!arrayType.is_none() &&
+            (elementNotNull == nullptr ||
+             std::all_of(elementNotNull + begin,
+                         elementNotNull + end,
+                         [](char item) { return item != 0; }))) {
+            return toArray(begin, end);
+        }
         py::list result;
-        for (int64_t i = offsets[rowId]; i < offsets[rowId + 1]; ++i) {
+        for (int64_t i = begin; i < end; ++i) {
             result.append(elementConverter->toPython(static_cast<uint64_t>(i)));
         }
         return result;
@@ -828,20 +1174,34 @@ void
 ListConverter::write(orc::ColumnVectorBatch* batch, uint64_t rowId, py::object elem)
 {
     size_t size = 0;
-    auto* listBatch = dynamic_cast<orc::ListVectorBatch*>(batch);
+    auto* listBatch = static_cast<orc::ListVectorBatch*>(batch);
     listBatch->offsets[0] = 0;
     uint64_t offset = static_cast<uint64_t>(listBatch->offsets[rowId]);
     if (elem.is(nullValue)) {
         listBatch->hasNulls = true;
         listBatch->notNull[rowId] = 0;
     } else {
-        py::list list(elem);
-        size = list.size();
-        if (listBatch->elements->capacity < offset + size) {
-            listBatch->elements->resize(2 * (offset + size));
+        py::object seq =
+          py::reinterpret_steal<py::object>(PySequence_Fast(elem.ptr(), ""));
+        if (!seq) {
+            if (PyErr_ExceptionMatches(PyExc_TypeError) == 1) {
+                PyErr_Clear();
+                std::stringstream errmsg;
+                errmsg << "Item " << (std::string)py::repr(elem)
+                       << " cannot be cast to list";
+                throw py::type_error(errmsg.str());
+            } else {
+                throw py::error_already_set();
+            }
         }
+        size = static_cast<size_t>(PySequence_Fast_GET_SIZE(seq.ptr()));
+        PyObject** items = PySequence_Fast_ITEMS(seq.ptr());
+        reserveChildren(
+          listBatch->elements.get(), listBatch->capacity, rowId, offset + size);
         for (size_t cnt = 0; cnt < size; ++cnt) {
-            elementConverter->write(listBatch->elements.get(), offset + cnt, list[cnt]);
+            elementConverter->write(listBatch->elements.get(),
+                                    offset + cnt,
+                                    py::reinterpret_borrow<py::object>(items[cnt]));
         }
         listBatch->notNull[rowId] = 1;
     }
@@ -859,12 +1219,16 @@ MapConverter::MapConverter(const orc::Type& type,
                            unsigned int structKind,
                            py::dict conv,
                            py::object tzone,
-                           py::object nv)
+                           py::object nv,
+                           bool listAsArray,
+                           orc::MemoryPool* pool)
   : Converter(nv)
   , offsets(nullptr)
 {
-    keyConverter = createConverter(type.getSubtype(0), structKind, conv, tzone, nv);
-    elementConverter = createConverter(type.getSubtype(1), structKind, conv, tzone, nv);
+    keyConverter = createConverter(
+      type.getSubtype(0), structKind, conv, tzone, nv, listAsArray, pool);
+    elementConverter = createConverter(
+      type.getSubtype(1), structKind, conv, tzone, nv, listAsArray, pool);
 }
 
 void
@@ -896,7 +1260,7 @@ void
 MapConverter::write(orc::ColumnVectorBatch* batch, uint64_t rowId, py::object elem)
 {
     uint64_t cnt = 0;
-    auto* mapBatch = dynamic_cast<orc::MapVectorBatch*>(batch);
+    auto* mapBatch = static_cast<orc::MapVectorBatch*>(batch);
     mapBatch->offsets[0] = 0;
     uint64_t offset = static_cast<uint64_t>(mapBatch->offsets[rowId]);
     if (elem.is(nullValue)) {
@@ -905,10 +1269,9 @@ MapConverter::write(orc::ColumnVectorBatch* batch, uint64_t rowId, py::object el
     } else {
         py::dict dict(elem);
         size_t size = dict.size();
-        if (mapBatch->keys->capacity < offset + size) {
-            mapBatch->elements->resize(2 * (offset + size));
-            mapBatch->keys->resize(2 * (offset + size));
-        }
+        reserveChildren(mapBatch->keys.get(), mapBatch->capacity, rowId, offset + size);
+        reserveChildren(
+          mapBatch->elements.get(), mapBatch->capacity, rowId, offset + size);
         for (auto item : dict) {
             py::object key = py::reinterpret_borrow<py::object>(item.first);
             py::object val = py::reinterpret_borrow<py::object>(item.second);
@@ -933,14 +1296,18 @@ UnionConverter::UnionConverter(const orc::Type& type,
                                unsigned int structKind,
                                py::dict conv,
                                py::object tzone,
-                               py::object nv)
+                               py::object nv,
+                               bool listAsArray,
+                               orc::MemoryPool* pool)
   : Converter(nv)
   , tags(nullptr)
   , offsets(nullptr)
 {
     for (size_t i = 0; i < type.getSubtypeCount(); ++i) {
         fieldConverters.push_back(
-          createConverter(type.getSubtype(i), structKind, conv, tzone, nv).release());
+          createConverter(
+            type.getSubtype(i), structKind, conv, tzone, nv, listAsArray, pool)
+            .release());
         childOffsets[static_cast<unsigned char>(i)] = 0;
     }
 }
@@ -977,7 +1344,7 @@ UnionConverter::toPython(uint64_t rowId)
 void
 UnionConverter::write(orc::ColumnVectorBatch* batch, uint64_t rowId, py::object elem)
 {
-    auto* unionBatch = dynamic_cast<orc::UnionVectorBatch*>(batch);
+    auto* unionBatch = static_cast<orc::UnionVectorBatch*>(batch);
     if (elem.is(nullValue)) {
         unionBatch->hasNulls = true;
         unionBatch->notNull[rowId] = 0;
@@ -1021,14 +1388,24 @@ StructConverter::StructConverter(const orc::Type& type,
                                  unsigned int kind_,
                                  py::dict conv,
                                  py::object tzone,
-                                 py::object nv)
+                                 py::object nv,
+                                 bool listAsArray,
+                                 orc::MemoryPool* pool)
   : Converter(nv)
   , kind(kind_)
 {
     for (size_t i = 0; i < type.getSubtypeCount(); ++i) {
         fieldConverters.push_back(
-          createConverter(type.getSubtype(i), kind, conv, tzone, nv).release());
-        fieldNames.push_back(py::str(type.getFieldName(i)));
+          createConverter(type.getSubtype(i), kind, conv, tzone, nv, listAsArray, pool)
+            .release());
+        /* Interned keys have their hash precomputed, and compare by identity
+           with the same literals of the user's code. */
+        PyObject* name = PyUnicode_FromString(type.getFieldName(i).c_str());
+        if (name == nullptr) {
+            throw py::error_already_set();
+        }
+        PyUnicode_InternInPlace(&name);
+        fieldNames.push_back(py::reinterpret_steal<py::str>(name));
     }
 }
 
@@ -1058,83 +1435,107 @@ StructConverter::toPython(uint64_t rowId)
         if (kind == 0) {
             py::tuple result = py::tuple(fieldConverters.size());
             for (size_t i = 0; i < fieldConverters.size(); ++i) {
-                result[i] = fieldConverters[i]->toPython(rowId);
+                PyTuple_SET_ITEM(result.ptr(),
+                                 static_cast<Py_ssize_t>(i),
+                                 fieldConverters[i]->toPython(rowId).release().ptr());
             }
             return result;
         } else {
             py::dict result;
             for (size_t i = 0; i < fieldConverters.size(); ++i) {
-                result[fieldNames[i]] = fieldConverters[i]->toPython(rowId);
+                py::object value = fieldConverters[i]->toPython(rowId);
+                PyObject* key = fieldNames[i].ptr();
+                if (PyDict_SetItem(result.ptr(), key, value.ptr()) != 0) {
+                    throw py::error_already_set();
+                }
             }
             return result;
         }
     }
 }
 
+void
+StructConverter::appendColumns(py::dict columns, uint64_t begin, uint64_t end)
+{
+    for (size_t i = 0; i < fieldConverters.size(); ++i) {
+        PyObject* column = PyDict_GetItem(columns.ptr(), fieldNames[i].ptr());
+        if (column == nullptr) {
+            py::list values;
+            columns[fieldNames[i]] = values;
+            column = values.ptr();
+        }
+        /* Convert the values field by field, instead of row by row. */
+        for (uint64_t rowId = begin; rowId < end; ++rowId) {
+            py::object value = fieldConverters[i]->toPython(rowId);
+            if (PyList_Append(column, value.ptr()) != 0) {
+                throw py::error_already_set();
+            }
+        }
+    }
+}
+
 void
 StructConverter::write(orc::ColumnVectorBatch* batch, uint64_t rowId, py::object elem)
 {
-    auto* structBatch = dynamic_cast<orc::StructVectorBatch*>(batch);
+    auto* structBatch = static_cast<orc::StructVectorBatch*>(batch);
+    size_t numFields = fieldConverters.size();
+    /* The fields are always resized together (StructVectorBatch::resize does
+       not resize them), so it's enough to check the first one. */
+    if (numFields > 0 && structBatch->fields[0]->capacity <= rowId) {
+        uint64_t size = std::max(2 * structBatch->fields[0]->capacity, rowId + 1);
+        for (size_t i = 0; i < numFields; ++i) {
+            structBatch->fields[i]->resize(size);
+        }
+    }
     if (elem.is(nullValue)) {
         structBatch->hasNulls = true;
         structBatch->notNull[rowId] = 0;
-        for (size_t i = 0; i < fieldConverters.size(); ++i) {
-            if (structBatch->fields[i]->capacity <=
-                structBatch->fields[i]->numElements) {
-                structBatch->fields[i]->resize(2 * structBatch->fields[i]->capacity);
-            }
+        for (size_t i = 0; i < numFields; ++i) {
             fieldConverters[i]->write(structBatch->fields[i], rowId, elem);
         }
     } else {
+        size_t i = 0;
         if (kind == 0) {
-            if (py::isinstance<py::tuple>(elem)) {
-                py::tuple tuple(elem);
-                for (size_t i = 0; i < fieldConverters.size(); ++i) {
-                    if (structBatch->fields[i]->capacity <=
-                        structBatch->fields[i]->numElements) {
-                        structBatch->fields[i]->resize(
-                          2 * structBatch->fields[i]->capacity);
-                    }
-                    try {
-                        fieldConverters[i]->write(
-                          structBatch->fields[i], rowId, tuple[i]);
-                    } catch (py::type_error& err) {
-                        std::stringstream errmsg;
-                        errmsg << " at struct field index " << i;
-                        throw py::type_error(err.what() + errmsg.str());
-                    }
-                }
-            } else {
+            if (!PyTuple_Check(elem.ptr())) {
                 std::stringstream errmsg;
                 errmsg << "Item " << (std::string)py::repr(elem)
                        << " is not an instance of tuple";
                 throw py::type_error(errmsg.str());
             }
-        } else {
-            if (py::isinstance<py::dict>(elem)) {
-                py::dict dict(elem);
-                for (size_t i = 0; i < fieldConverters.size(); ++i) {
-                    if (structBatch->fields[i]->capacity <=
-                        structBatch->fields[i]->numElements) {
-                        structBatch->fields[i]->resize(
-                          2 * structBatch->fields[i]->capacity);
-                    }
-                    try {
-                        fieldConverters[i]->write(
-                          structBatch->fields[i], rowId, dict[fieldNames[i]]);
-                    } catch (py::type_error& err) {
-                        std::stringstream errmsg;
-                        errmsg << " at struct field name '"
-                               << (std::string)fieldNames[i] << "'";
-                        throw py::type_error(err.what() + errmsg.str());
+            size_t size = static_cast<size_t>(PyTuple_GET_SIZE(elem.ptr()));
+            PyObject** items = PySequence_Fast_ITEMS(elem.ptr());
+            try {
+                for (; i < numFields; ++i) {
+                    if (i >= size) {
+                        throw py::index_error("tuple index out of range");
                     }
+                    py::object item = py::reinterpret_borrow<py::object>(items[i]);
+                    fieldConverters[i]->write(structBatch->fields[i], rowId, item);
                 }
-            } else {
+            } catch (py::type_error& err) {
+                std::stringstream errmsg;
+                errmsg << " at struct field index " << i;
+                throw py::type_error(err.what() + errmsg.str());
+            }
+        } else {
+            if (!py::isinstance<py::dict>(elem)) {
                 std::stringstream errmsg;
                 errmsg << "Item " << (std::string)py::repr(elem)
                        << " is not an instance of dictionary";
                 throw py::type_error(errmsg.str());
             }
+            py::dict dict(elem);
+            try {
+                for (; i < numFields; ++i) {
+                    fieldConverters[i]->write(
+                      structBatch->fields[i], rowId, dict[fieldNames[i]]);
+                }
+            } catch (py::type_error& err) {
+                std::stringstream errmsg;
+                errmsg << " at struct field name '" << (std::string)fieldNames[i]
+                       << "'";
+                throw py::type_error(err.what() + errmsg.str());
+            }
         }
         structBatch->notNull[rowId] = 1;
     }
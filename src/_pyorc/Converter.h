@@ -22,10 +22,17 @@ class Converter
     virtual py::object toPython(uint64_t) = 0;
     virtual void write(orc::ColumnVectorBatch*, uint64_t, py::object) = 0;
     virtual void reset(const orc::ColumnVectorBatch&);
+    virtual void appendColumns(py::dict, uint64_t, uint64_t);
     virtual void clear(){};
 };
 
 std::unique_ptr<Converter>
-createConverter(const orc::Type*, unsigned int, py::dict, py::object, py::object);
+createConverter(const orc::Type*,
+                unsigned int,
+                py::dict,
+                py::object,
+                py::object,
+                bool = false,
+                orc::MemoryPool* = nullptr);
 
 #endif
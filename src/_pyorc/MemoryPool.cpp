@@ -0,0 +1,166 @@
+#include <cstdlib>
+#include <sstream>
+
+#include "MemoryPool.h"
+
+/* Every block starts with a header that stores its size and size class.
+   Its length keeps the returned pointers aligned as std::malloc's. */
+static const uint64_t headerSize = 16;
+/* Blocks are rounded up to power of two size classes between 64 bytes and
+   4 MiB. Larger blocks are allocated directly and never cached. */
+static const uint32_t minClassBits = 6;
+static const uint32_t maxClassBits = 22;
+static const uint64_t numSizeClasses = maxClassBits - minClassBits + 1;
+
+static uint64_t
+sizeClassOf(uint64_t size)
+{
+    uint32_t bits = minClassBits;
+    while ((1ULL << bits) < size) {
+        ++bits;
+    }
+    return bits - minClassBits;
+}
+
+PyORCMemoryPool::PyORCMemoryPool(uint64_t limit_, uint64_t max_cached)
+  : limit(limit_)
+  , maxCached(max_cached)
+  , liveBytes(0)
+  , peakBytes(0)
+  , cachedBytes(0)
+  , allocations(0)
+  , freeLists(numSizeClasses)
+{}
+
+PyORCMemoryPool::~PyORCMemoryPool()
+{
+    release();
+}
+
+char*
+PyORCMemoryPool::malloc(uint64_t size)
+{
+    uint64_t blockSize = size + headerSize;
+    uint64_t sizeClass = numSizeClasses;
+    if (blockSize <= (1ULL << maxClassBits)) {
+        sizeClass = sizeClassOf(blockSize);
+        blockSize = 1ULL << (sizeClass + minClassBits);
+    }
+    char* block = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (limit != 0 && liveBytes + blockSize > limit) {
+            std::stringstream errmsg;
+            errmsg << "Failed to allocate " << size << " bytes, the memory pool's "
+                   << "limit of " << limit << " bytes would be exceeded ("
+                   << liveBytes << " bytes in use)";
+            throw MemoryLimitError(errmsg.str());
+        }
+        if (sizeClass < numSizeClasses && !freeLists[sizeClass].empty()) {
+            block = freeLists[sizeClass].back();
+            freeLists[sizeClass].pop_back();
+            cachedBytes -= blockSize;
+        }
+        liveBytes += blockSize;
+        if (liveBytes > peakBytes) {
+            peakBytes = liveBytes;
+        }
+        ++allocations;
+    }
+    if (block == nullptr) {
+        block = static_cast<char*>(std::malloc(blockSize));
+        if (block == nullptr) {
+            std::lock_guard<std::mutex> lock(mutex);
+            liveBytes -= blockSize;
+            throw std::bad_alloc();
+        }
+    }
+    uint64_t* header = reinterpret_cast<uint64_t*>(block);
+    header[0] = blockSize;
+    header[1] = sizeClass;
+    return block + headerSize;
+}
+
+void
+PyORCMemoryPool::free(char* ptr)
+{
+    if (ptr == nullptr) {
+        return;
+    }
+    char* block = ptr - headerSize;
+    const uint64_t* header = reinterpret_cast<const uint64_t*>(block);
+    uint64_t blockSize = header[0];
+    uint64_t sizeClass = header[1];
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        liveBytes -= blockSize;
+        if (sizeClass < numSizeClasses && cachedBytes + blockSize <= maxCached) {
+            freeLists[sizeClass].push_back(block);
+            cachedBytes += blockSize;
+            return;
+        }
+    }
+    std::free(block);
+}
+
+void
+PyORCMemoryPool::release()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& freeList : freeLists) {
+        for (char* block : freeList) {
+            std::free(block);
+        }
+        freeList.clear();
+    }
+    cachedBytes = 0;
+}
+
+void
+PyORCMemoryPool::resetPeak()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    peakBytes = liveBytes;
+}
+
+uint64_t
+PyORCMemoryPool::getLimit()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return limit;
+}
+
+void
+PyORCMemoryPool::setLimit(uint64_t limit_)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    limit = limit_;
+}
+
+uint64_t
+PyORCMemoryPool::getLiveBytes()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return liveBytes;
+}
+
+uint64_t
+PyORCMemoryPool::getPeakBytes()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return peakBytes;
+}
+
+uint64_t
+PyORCMemoryPool::getCachedBytes()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return cachedBytes;
+}
+
+uint64_t
+PyORCMemoryPool::getAllocations()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return allocations;
+}
@@ -0,0 +1,50 @@
+#ifndef MEMORY_POOL_H
+#define MEMORY_POOL_H
+
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "orc/MemoryPool.hh"
+
+class MemoryLimitError : public std::bad_alloc
+{
+  private:
+    std::string message;
+
+  public:
+    MemoryLimitError(std::string msg)
+      : message(std::move(msg))
+    {}
+    const char* what() const noexcept override { return message.c_str(); }
+};
+
+class PyORCMemoryPool : public orc::MemoryPool
+{
+  private:
+    std::mutex mutex;
+    uint64_t limit;
+    uint64_t maxCached;
+    uint64_t liveBytes;
+    uint64_t peakBytes;
+    uint64_t cachedBytes;
+    uint64_t allocations;
+    std::vector<std::vector<char*>> freeLists;
+
+  public:
+    PyORCMemoryPool(uint64_t = 0, uint64_t = 67108864);
+    ~PyORCMemoryPool() override;
+    char* malloc(uint64_t) override;
+    void free(char*) override;
+    void release();
+    void resetPeak();
+    uint64_t getLimit();
+    void setLimit(uint64_t);
+    uint64_t getLiveBytes();
+    uint64_t getPeakBytes();
+    uint64_t getCachedBytes();
+    uint64_t getAllocations();
+};
+
+#endif
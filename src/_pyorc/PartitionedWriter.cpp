@@ -0,0 +1,139 @@
+#include "PartitionedWriter.h"
+
+PartitionedWriter::PartitionedWriter(py::object open_writer,
+                                     py::list key_fields,
+                                     py::object memory_pool,
+                                     uint64_t max_open_files,
+                                     uint64_t memory_limit,
+                                     uint64_t max_rows,
+                                     uint64_t max_bytes)
+{
+    currentRow = 0;
+    if (!PyCallable_Check(open_writer.ptr())) {
+        throw py::type_error("Parameter `open_writer` must be callable");
+    }
+    if (key_fields.size() == 0) {
+        throw py::value_error("At least one partition key field is required");
+    }
+    opener = open_writer;
+    for (auto field : key_fields) {
+        keyFields.push_back(py::reinterpret_borrow<py::object>(field));
+    }
+    if (!memory_pool.is_none()) {
+        pool = &py::cast<PyORCMemoryPool&>(memory_pool);
+        memoryPool = memory_pool;
+    } else if (memory_limit != 0) {
+        throw py::value_error("A memory pool is required for the memory limit");
+    }
+    maxOpenFiles = max_open_files;
+    memoryLimit = memory_limit;
+    maxRows = max_rows;
+    maxBytes = max_bytes;
+}
+
+size_t
+PartitionedWriter::route(py::handle row)
+{
+    py::tuple key(keyFields.size());
+    for (size_t i = 0; i < keyFields.size(); ++i) {
+        key[i] = row[keyFields[i]];
+    }
+    size_t idx;
+    py::object pos = index.attr("get")(key);
+    if (pos.is_none()) {
+        idx = partitions.size();
+        Partition part;
+        part.key = key;
+        partitions.push_back(std::move(part));
+        index[key] = idx;
+    } else {
+        idx = py::cast<size_t>(pos);
+    }
+    Partition& part = partitions[idx];
+    if (part.native == nullptr) {
+        openPartition(idx);
+    } else {
+        lru.splice(lru.begin(), lru, part.lruPos);
+    }
+    return idx;
+}
+
+void
+PartitionedWriter::openPartition(size_t idx)
+{
+    Partition& part = partitions[idx];
+    py::object writer = opener(part.key, part.seq);
+    part.native = py::cast<Writer*>(writer);
+    part.writer = writer;
+    lru.push_front(idx);
+    part.lruPos = lru.begin();
+    enforceLimits();
+}
+
+void
+PartitionedWriter::closePartition(size_t idx)
+{
+    Partition& part = partitions[idx];
+    py::object writer = part.writer;
+    lru.erase(part.lruPos);
+    part.writer = py::none();
+    part.native = nullptr;
+    ++part.seq;
+    writer.attr("close")();
+}
+
+void
+PartitionedWriter::enforceLimits()
+{
+    /* The current partition is always at the front, it is never closed. */
+    while (lru.size() > 1) {
+        if (maxOpenFiles != 0 && lru.size() > maxOpenFiles) {
+            closePartition(lru.back());
+        } else if (memoryLimit != 0 && pool->getLiveBytes() > memoryLimit) {
+            closePartition(lru.back());
+        } else {
+            break;
+        }
+    }
+}
+
+void
+PartitionedWriter::write(py::object row)
+{
+    size_t idx = route(row);
+    Writer* writer = partitions[idx].native;
+    writer->write(row);
+    ++currentRow;
+    if ((maxRows != 0 && writer->currentRow >= maxRows) ||
+        (maxBytes != 0 && writer->bytesWritten() >= maxBytes)) {
+        closePartition(idx);
+    } else if (memoryLimit != 0) {
+        enforceLimits();
+    }
+}
+
+uint64_t
+PartitionedWriter::writerows(py::iterable iter)
+{
+    uint64_t rows = 0;
+    for (auto handle : iter) {
+        auto obj = py::cast<py::object>(handle);
+        this->write(obj);
+        ++rows;
+    }
+    return rows;
+}
+
+void
+PartitionedWriter::close()
+{
+    while (!lru.empty()) {
+        closePartition(lru.back());
+    }
+}
+
+uint64_t
+PartitionedWriter::openPartitions() const
+{
+    return lru.size();
+}
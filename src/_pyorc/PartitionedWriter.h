@@ -0,0 +1,61 @@
+#ifndef PARTITIONED_WRITER_H
+#define PARTITIONED_WRITER_H
+
+#include <list>
+#include <vector>
+
+#include <pybind11/pybind11.h>
+
+#include "MemoryPool.h"
+#include "Writer.h"
+
+namespace py = pybind11;
+
+/* The output of a single partition key. The writer is None, if the current
+   file of the partition is closed. */
+struct Partition
+{
+    py::object key;
+    py::object writer;
+    Writer* native = nullptr;
+    uint64_t seq = 0;
+    std::list<size_t>::iterator lruPos;
+};
+
+class PartitionedWriter
+{
+  private:
+    py::object memoryPool;
+    PyORCMemoryPool* pool = nullptr;
+    py::object opener;
+    std::vector<py::object> keyFields;
+    uint64_t maxOpenFiles;
+    uint64_t memoryLimit;
+    uint64_t maxRows;
+    uint64_t maxBytes;
+    py::dict index;
+    std::vector<Partition> partitions;
+    /* The indices of the open partitions, the most recently used first. */
+    std::list<size_t> lru;
+    size_t route(py::handle);
+    void openPartition(size_t);
+    void closePartition(size_t);
+    void enforceLimits();
+
+  public:
+    uint64_t currentRow;
+
+    PartitionedWriter(py::object,
+                      py::list,
+                      py::object = py::none(),
+                      uint64_t = 0,
+                      uint64_t = 0,
+                      uint64_t = 0,
+                      uint64_t = 0);
+    void write(py::object);
+    uint64_t writerows(py::iterable);
+    void close();
+    uint64_t openPartitions() const;
+};
+
+#endif
@@ -1,3 +1,7 @@
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
 #include "PyORCStream.h"
 
 PyORCInputStream::PyORCInputStream(py::object fp)
@@ -68,9 +72,13 @@ PyORCInputStream::read(void* buf, uint64_t length, uint64_t offset)
 
 PyORCInputStream::~PyORCInputStream() {}
 
-PyORCOutputStream::PyORCOutputStream(py::object fp)
+PyORCOutputStream::PyORCOutputStream(py::object fp,
+                                     uint64_t buffer_size,
+                                     StreamMetrics* metrics_)
 {
     bytesWritten = 0;
+    bufferSize = buffer_size;
+    metrics = metrics_;
     if (!(py::hasattr(fp, "write") && py::hasattr(fp, "flush"))) {
         throw py::type_error("Parameter must be a file-like object, but `" +
                              (std::string)(py::str(fp.get_type())) + "` was provided");
@@ -83,6 +91,7 @@ PyORCOutputStream::PyORCOutputStream(py::object fp)
         filename = py::cast<std::string>(py::repr(fp));
     }
     closed = py::cast<bool>(fp.attr("closed"));
+    buffer.reserve(bufferSize);
 }
 
 uint64_t
@@ -104,20 +113,28 @@ PyORCOutputStream::getName() const
 }
 
 void
-PyORCOutputStream::write(const void* buf, size_t length)
+PyORCOutputStream::writeToPython(const char* data, size_t length)
 {
-    if (closed) {
-        throw std::logic_error("Cannot write to closed stream");
-    }
+    /* The ORC writer might call the stream with released GIL. */
+    py::gil_scoped_acquire gil;
+    auto start = std::chrono::steady_clock::now();
     try {
-        py::bytes data = py::bytes(static_cast<const char*>(buf), length);
-        size_t count = py::cast<size_t>(pywrite(data));
-        pyflush();
-
-        if (count != length) {
-            throw orc::ParseError("Shorter write of " + filename);
-        }
-        bytesWritten += static_cast<uint64_t>(count);
+        do {
+            /* The object might keep a reference to what it gets, therefore it
+               cannot be a view of the buffer, that is reused. */
+            py::object res = pywrite(py::bytes(data, length));
+            /* Returning None from write is common for file-like objects that
+               are not derived from io classes, and it is taken as the whole
+               content has been written. The None of a non-blocking raw
+               stream, that would mean no bytes were written, cannot be
+               told apart from this, such streams are not supported. */
+            size_t count = res.is_none() ? length : py::cast<size_t>(res);
+            if (count == 0 && length > 0) {
+                throw orc::ParseError("Shorter write of " + filename);
+            }
+            data += count;
+            length -= count;
+        } while (length > 0);
     } catch (py::error_already_set& err) {
         if (!err.matches(PyExc_TypeError)) {
             throw;
@@ -125,12 +142,50 @@ PyORCOutputStream::write(const void* buf, size_t length)
         throw orc::ParseError(
           "Failed to write content as bytes. Stream might not be opened as binary");
     }
+    if (metrics != nullptr) {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        metrics->writeLatencyNs +=
+          std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        ++metrics->writeCall;
+    }
+}
+
+void
+PyORCOutputStream::flushBuffer()
+{
+    if (!buffer.empty()) {
+        writeToPython(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+}
+
+void
+PyORCOutputStream::write(const void* buf, size_t length)
+{
+    if (closed) {
+        throw std::logic_error("Cannot write to closed stream");
+    }
+    const char* data = static_cast<const char*>(buf);
+    if (buffer.size() + length > bufferSize) {
+        flushBuffer();
+    }
+    if (length >= bufferSize || bytesWritten == 0) {
+        /* Large writes (or every write without a buffer) go directly to the
+           file-like object. So does the first one (the file header), thus a
+           read-only or text stream fails when the Writer is created. */
+        writeToPython(data, length);
+    } else {
+        buffer.insert(buffer.end(), data, data + length);
+    }
+    bytesWritten += static_cast<uint64_t>(length);
 }
 
 void
 PyORCOutputStream::close()
 {
     if (!closed) {
+        flushBuffer();
+        py::gil_scoped_acquire gil;
         try {
             pyflush();
         } catch (py::error_already_set& err) {
@@ -149,6 +204,8 @@ void
 PyORCOutputStream::flush()
 {
     if (!closed) {
+        flushBuffer();
+        py::gil_scoped_acquire gil;
         pyflush();
     }
 }
@@ -156,5 +213,117 @@ PyORCOutputStream::flush()
 
 PyORCOutputStream::~PyORCOutputStream()
 {
-    close();
+    try {
+        close();
+    } catch (...) {
+        // Destructors must not throw, the data is lost if the Writer was not closed.
+    }
+}
+
+NativeOutputStream::NativeOutputStream(const std::string& path,
+                                       uint64_t buffer_size,
+                                       StreamMetrics* metrics_)
+{
+    filename = path;
+    bytesWritten = 0;
+    metrics = metrics_;
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, path.c_str());
+        throw py::error_already_set();
+    }
+    setBuffer(buffer_size);
+}
+
+void
+NativeOutputStream::setBuffer(uint64_t size)
+{
+    if (size == 0) {
+        std::setvbuf(file, nullptr, _IONBF, 0);
+    } else {
+        buffer.resize(size);
+        std::setvbuf(file, buffer.data(), _IOFBF, size);
+    }
+}
+
+uint64_t
+NativeOutputStream::getLength() const
+{
+    return bytesWritten;
+}
+
+uint64_t
+NativeOutputStream::getNaturalWriteSize() const
+{
+    return 128 * 1024;
+}
+
+const std::string&
+NativeOutputStream::getName() const
+{
+    return filename;
+}
+
+void
+NativeOutputStream::write(const void* buf, size_t length)
+{
+    if (file == nullptr) {
+        throw std::logic_error("Cannot write to closed stream");
+    }
+    auto start = std::chrono::steady_clock::now();
+    if (std::fwrite(buf, 1, length, file) != length) {
+        throw orc::ParseError("Failed to write " + filename + ": " +
+                              std::strerror(errno));
+    }
+    bytesWritten += static_cast<uint64_t>(length);
+    if (metrics != nullptr) {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        metrics->writeLatencyNs +=
+          std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        ++metrics->writeCall;
+    }
+}
+
+void
+NativeOutputStream::close()
+{
+    if (file != nullptr) {
+        int rc = std::fclose(file);
+        file = nullptr;
+        if (rc != 0) {
+            throw orc::ParseError("Failed to close " + filename + ": " +
+                                  std::strerror(errno));
+        }
+    }
+}
+
+#if ORC_VERSION_AT_LEAST(1, 9, 0)
+void
+NativeOutputStream::flush()
+{
+    if (file != nullptr && std::fflush(file) != 0) {
+        throw orc::ParseError("Failed to flush " + filename + ": " +
+                              std::strerror(errno));
+    }
+}
+#endif
+
+NativeOutputStream::~NativeOutputStream()
+{
+    if (file != nullptr) {
+        std::fclose(file);
+    }
+}
+
+std::unique_ptr<orc::OutputStream>
+createOutputStream(py::object fileo, uint64_t bufferSize, StreamMetrics* metrics)
+{
+    if (py::isinstance<py::str>(fileo) || py::isinstance<py::bytes>(fileo) ||
+        py::hasattr(fileo, "__fspath__")) {
+        py::object path = py::module::import("os").attr("fsdecode")(fileo);
+        return std::unique_ptr<orc::OutputStream>(
+          new NativeOutputStream(py::cast<std::string>(path), bufferSize, metrics));
+    }
+    return std::unique_ptr<orc::OutputStream>(
+      new PyORCOutputStream(fileo, bufferSize, metrics));
 }
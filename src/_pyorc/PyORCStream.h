@@ -1,6 +1,9 @@
 #ifndef PY_ORC_STREAM_H
 #define PY_ORC_STREAM_H
 
+#include <cstdio>
+#include <vector>
+
 #include <pybind11/pybind11.h>
 
 #include "orc/OrcFile.hh"
@@ -25,6 +28,12 @@ class PyORCInputStream : public orc::InputStream
     const std::string& getName() const override;
 };
 
+struct StreamMetrics
+{
+    uint64_t writeCall = 0;
+    uint64_t writeLatencyNs = 0;
+};
+
 class PyORCOutputStream : public orc::OutputStream
 {
   private:
@@ -33,9 +42,14 @@ class PyORCOutputStream : public orc::OutputStream
     py::object pyflush;
     uint64_t bytesWritten;
     bool closed;
+    StreamMetrics* metrics;
+    std::vector<char> buffer;
+    uint64_t bufferSize;
+    void writeToPython(const char*, size_t);
+    void flushBuffer();
 
   public:
-    PyORCOutputStream(py::object);
+    PyORCOutputStream(py::object, uint64_t = 8388608, StreamMetrics* = nullptr);
     ~PyORCOutputStream() override;
     uint64_t getLength() const override;
     uint64_t getNaturalWriteSize() const override;
@@ -47,4 +61,30 @@ class PyORCOutputStream : public orc::OutputStream
 #endif
 };
 
+class NativeOutputStream : public orc::OutputStream
+{
+  private:
+    std::string filename;
+    FILE* file;
+    std::vector<char> buffer;
+    uint64_t bytesWritten;
+    StreamMetrics* metrics;
+    void setBuffer(uint64_t);
+
+  public:
+    NativeOutputStream(const std::string&, uint64_t, StreamMetrics* = nullptr);
+    ~NativeOutputStream() override;
+    uint64_t getLength() const override;
+    uint64_t getNaturalWriteSize() const override;
+    const std::string& getName() const override;
+    void write(const void*, size_t) override;
+    void close() override;
+#if ORC_VERSION_AT_LEAST(1, 9, 0)
+    void flush() override;
+#endif
+};
+
+std::unique_ptr<orc::OutputStream>
+createOutputStream(py::object, uint64_t, StreamMetrics* = nullptr);
+
 #endif
@@ -1,8 +1,16 @@
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <sstream>
+
 #include <pybind11/stl.h>
 
+#include "MemoryPool.h"
 #include "PyORCStream.h"
 #include "Reader.h"
+#include "Reduction.h"
 #include "SearchArgument.h"
+#include "VectorBatch.h"
 
 using namespace py::literals;
 
@@ -16,132 +24,123 @@ createAttributeDict(const orc::Type& orcType)
     return result;
 }
 
-py::object
-createTypeDescription(const orc::Type& orcType)
+static py::object
+buildTypeDescription(const orc::Type& orcType, py::object typeModule)
 {
-    py::object typeModule = py::module::import("pyorc.typedescription");
-    int kind = static_cast<int>(orcType.getKind());
-    py::object attrDict = createAttributeDict(orcType);
-    switch (kind) {
-        case orc::BOOLEAN: {
-            py::object typeDesc = typeModule.attr("Boolean")();
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
-        }
-        case orc::BYTE: {
-            py::object typeDesc = typeModule.attr("TinyInt")();
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
-        }
-        case orc::SHORT: {
-            py::object typeDesc = typeModule.attr("SmallInt")();
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
-        }
-        case orc::INT: {
-            py::object typeDesc = typeModule.attr("Int")();
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
-        }
-        case orc::LONG: {
-            py::object typeDesc = typeModule.attr("BigInt")();
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
-        }
-        case orc::FLOAT: {
-            py::object typeDesc = typeModule.attr("Float")();
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
-        }
-        case orc::DOUBLE: {
-            py::object typeDesc = typeModule.attr("Double")();
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
-        }
-        case orc::STRING: {
-            py::object typeDesc = typeModule.attr("String")();
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
-        }
-        case orc::BINARY: {
-            py::object typeDesc = typeModule.attr("Binary")();
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
-        }
-        case orc::TIMESTAMP: {
-            py::object typeDesc = typeModule.attr("Timestamp")();
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
-        }
-        case orc::TIMESTAMP_INSTANT: {
-            py::object typeDesc = typeModule.attr("TimestampInstant")();
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
-        }
-        case orc::DATE: {
-            py::object typeDesc = typeModule.attr("Date")();
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
-        }
-        case orc::CHAR: {
-            py::object typeDesc =
-              typeModule.attr("Char")(py::cast(orcType.getMaximumLength()));
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
-        }
-        case orc::VARCHAR: {
-            py::object typeDesc =
-              typeModule.attr("VarChar")(py::cast(orcType.getMaximumLength()));
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
-        }
-        case orc::DECIMAL: {
-            py::object typeDesc = typeModule.attr("Decimal")(
+    py::object typeDesc;
+    switch (static_cast<int>(orcType.getKind())) {
+        case orc::BOOLEAN:
+            typeDesc = typeModule.attr("Boolean")();
+            break;
+        case orc::BYTE:
+            typeDesc = typeModule.attr("TinyInt")();
+            break;
+        case orc::SHORT:
+            typeDesc = typeModule.attr("SmallInt")();
+            break;
+        case orc::INT:
+            typeDesc = typeModule.attr("Int")();
+            break;
+        case orc::LONG:
+            typeDesc = typeModule.attr("BigInt")();
+            break;
+        case orc::FLOAT:
+            typeDesc = typeModule.attr("Float")();
+            break;
+        case orc::DOUBLE:
+            typeDesc = typeModule.attr("Double")();
+            break;
+        case orc::STRING:
+            typeDesc = typeModule.attr("String")();
+            break;
+        case orc::BINARY:
+            typeDesc = typeModule.attr("Binary")();
+            break;
+        case orc::TIMESTAMP:
+            typeDesc = typeModule.attr("Timestamp")();
+            break;
+        case orc::TIMESTAMP_INSTANT:
+            typeDesc = typeModule.attr("TimestampInstant")();
+            break;
+        case orc::DATE:
+            typeDesc = typeModule.attr("Date")();
+            break;
+        case orc::CHAR:
+            typeDesc = typeModule.attr("Char")(py::cast(orcType.getMaximumLength()));
+            break;
+        case orc::VARCHAR:
+            typeDesc = typeModule.attr("VarChar")(py::cast(orcType.getMaximumLength()));
+            break;
+        case orc::DECIMAL:
+            typeDesc = typeModule.attr("Decimal")(
               "precision"_a = py::cast(orcType.getPrecision()),
               "scale"_a = py::cast(orcType.getScale()));
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
-        }
-        case orc::LIST: {
-            py::object typeDesc =
-              typeModule.attr("Array")(createTypeDescription(*orcType.getSubtype(0)));
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
-        }
-        case orc::MAP: {
-            py::object typeDesc = typeModule.attr("Map")(
-              "key"_a = createTypeDescription(*orcType.getSubtype(0)),
-              "value"_a = createTypeDescription(*orcType.getSubtype(1)));
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
-        }
+            break;
+        case orc::LIST:
+            typeDesc = typeModule.attr("Array")(
+              buildTypeDescription(*orcType.getSubtype(0), typeModule));
+            break;
+        case orc::MAP:
+            typeDesc = typeModule.attr("Map")(
+              "key"_a = buildTypeDescription(*orcType.getSubtype(0), typeModule),
+              "value"_a = buildTypeDescription(*orcType.getSubtype(1), typeModule));
+            break;
         case orc::UNION: {
             py::tuple args(orcType.getSubtypeCount());
             for (size_t i = 0; i < orcType.getSubtypeCount(); ++i) {
-                args[i] = createTypeDescription(*orcType.getSubtype(i));
+                args[i] = buildTypeDescription(*orcType.getSubtype(i), typeModule);
             }
-            py::object typeDesc = typeModule.attr("Union")(*args);
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
+            typeDesc = typeModule.attr("Union")(*args);
+            break;
         }
         case orc::STRUCT: {
             py::dict fields;
             for (size_t i = 0; i < orcType.getSubtypeCount(); ++i) {
                 auto key = orcType.getFieldName(i);
-                fields[key.c_str()] = createTypeDescription(*orcType.getSubtype(i));
+                fields[key.c_str()] =
+                  buildTypeDescription(*orcType.getSubtype(i), typeModule);
             }
-            py::object typeDesc = typeModule.attr("Struct")(**fields);
-            typeDesc.attr("set_attributes")(attrDict);
-            return typeDesc;
+            typeDesc = typeModule.attr("Struct")(**fields);
+            break;
         }
         default:
             throw py::type_error("Invalid TypeKind");
     }
+    /* Most of the types have no attributes, skip the call for them. */
+    if (!orcType.getAttributeKeys().empty()) {
+        typeDesc.attr("set_attributes")(createAttributeDict(orcType));
+    }
+    return typeDesc;
+}
+
+py::object
+createTypeDescription(const orc::Type& orcType)
+{
+    return buildTypeDescription(orcType,
+                                py::module::import("pyorc.typedescription"));
+}
+
+py::object
+ORCFileLikeObject::convertRow(uint64_t rowId)
+{
+    if (!metrics) {
+        return converter->toPython(rowId);
+    }
+    auto start = std::chrono::steady_clock::now();
+    py::object val = converter->toPython(rowId);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    metrics->conversionLatencyNs +=
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    ++metrics->conversionCall;
+    return val;
 }
 
 py::object
 ORCFileLikeObject::next()
 {
+    if (!converter) {
+        prepareRead();
+    }
     while (true) {
         if (batchItem == 0) {
             if (!rowReader->next(*batch)) {
@@ -150,7 +149,7 @@ ORCFileLikeObject::next()
             converter->reset(*batch);
         }
         if (batchItem < batch->numElements) {
-            py::object val = converter->toPython(batchItem);
+            py::object val = convertRow(batchItem);
             ++batchItem;
             ++currentRow;
             return val;
@@ -160,14 +159,53 @@ ORCFileLikeObject::next()
     }
 }
 
-py::list
+void
+ORCFileLikeObject::convertColumns(py::dict columns, uint64_t begin, uint64_t end)
+{
+    if (!metrics) {
+        converter->appendColumns(columns, begin, end);
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    converter->appendColumns(columns, begin, end);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    metrics->conversionLatencyNs +=
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    metrics->conversionCall += end - begin;
+}
+
+py::object
 ORCFileLikeObject::read(int64_t num)
 {
     int64_t i = 0;
-    py::list res;
     if (num < -1) {
         throw py::value_error("Read length must be positive or -1");
     }
+    if (columnar) {
+        if (!converter) {
+            prepareRead();
+        }
+        py::dict res;
+        converter->appendColumns(res, 0, 0);
+        while (num == -1 || i < num) {
+            if (batchItem == 0) {
+                if (!rowReader->next(*batch)) {
+                    break;
+                }
+                converter->reset(*batch);
+            }
+            uint64_t end = batch->numElements;
+            if (num != -1) {
+                end = std::min(end, batchItem + static_cast<uint64_t>(num - i));
+            }
+            convertColumns(res, batchItem, end);
+            i += end - batchItem;
+            currentRow += end - batchItem;
+            batchItem = end < batch->numElements ? end : 0;
+        }
+        return res;
+    }
+    py::list res;
     try {
         while (true) {
             if (num != -1 && i == num) {
@@ -181,10 +219,45 @@ ORCFileLikeObject::read(int64_t num)
     }
 }
 
+py::object
+ORCFileLikeObject::nextBatch()
+{
+    if (!converter) {
+        prepareRead();
+    }
+    if (batchItem == 0 || batchItem >= batch->numElements) {
+        if (!rowReader->next(*batch)) {
+            throw py::stop_iteration();
+        }
+        converter->reset(*batch);
+        batchItem = 0;
+    }
+    uint64_t begin = batchItem;
+    uint64_t end = batch->numElements;
+    py::object res;
+    if (columnar) {
+        py::dict columns;
+        convertColumns(columns, begin, end);
+        res = columns;
+    } else {
+        py::list rows;
+        for (uint64_t rowId = begin; rowId < end; ++rowId) {
+            rows.append(convertRow(rowId));
+        }
+        res = rows;
+    }
+    currentRow += end - begin;
+    batchItem = 0;
+    return res;
+}
+
 uint64_t
 ORCFileLikeObject::seek(int64_t row, uint16_t whence)
 {
     uint64_t start = 0;
+    if (!converter) {
+        prepareRead();
+    }
     switch (whence) {
         case 0:
             start = firstRowOfStripe;
@@ -225,6 +298,29 @@ ORCFileLikeObject::findColumnType(const orc::Type* type, uint64_t columnIndex) c
     }
 }
 
+const orc::Type*
+ORCFileLikeObject::columnType(const orc::Type& root, uint64_t columnIndex)
+{
+    if (columnTypes.empty()) {
+        columnTypes.resize(root.getMaximumColumnId() + 1);
+        std::vector<const orc::Type*> stack = { &root };
+        while (!stack.empty()) {
+            const orc::Type* type = stack.back();
+            stack.pop_back();
+            columnTypes[type->getColumnId()] = type;
+            for (size_t i = 0; i < type->getSubtypeCount(); ++i) {
+                stack.push_back(type->getSubtype(i));
+            }
+        }
+    }
+    /* The selected type keeps the column ids of the file, the columns that
+       are not selected are missing from the table. */
+    if (columnIndex >= columnTypes.size() || columnTypes[columnIndex] == nullptr) {
+        throw py::index_error("column not found");
+    }
+    return columnTypes[columnIndex];
+}
+
 py::object
 ORCFileLikeObject::convertTimestampMillis(int64_t millisec) const
 {
@@ -369,7 +465,12 @@ Reader::Reader(py::object fileo,
                unsigned int struct_repr,
                py::object conv,
                py::object predicate,
-               py::object null_value)
+               py::object null_value,
+               py::object memory_pool,
+               bool collect_metrics,
+               bool metadata_only,
+               bool tight_numeric_vector,
+               bool numeric_arrays)
 {
     orc::ReaderOptions readerOpts;
     batchItem = 0;
@@ -377,6 +478,10 @@ Reader::Reader(py::object fileo,
     firstRowOfStripe = 0;
     structKind = struct_repr;
     nullValue = null_value;
+    metadataOnly = metadata_only;
+    numericArrays = numeric_arrays;
+    selectsColumns = !col_indices.empty() || !col_names.empty();
+    filtersRows = !predicate.is_none() && !metadataOnly;
     if (!col_indices.empty() && !col_names.empty()) {
         throw py::value_error(
           "Either col_indices or col_names can be set to select columns");
@@ -392,6 +497,9 @@ Reader::Reader(py::object fileo,
         rowReaderOpts = rowReaderOpts.setTimezoneName(tzKey);
     }
     timezoneInfo = tzone;
+#if ORC_VERSION_AT_LEAST(1, 9, 0)
+    rowReaderOpts = rowReaderOpts.setUseTightNumericVector(tight_numeric_vector);
+#endif
     if (conv.is_none()) {
         py::dict defaultConv =
           py::module::import("pyorc.converters").attr("DEFAULT_CONVERTERS");
@@ -399,18 +507,70 @@ Reader::Reader(py::object fileo,
     } else {
         convDict = conv;
     }
-    if (!predicate.is_none()) {
+    if (filtersRows) {
         rowReaderOpts = rowReaderOpts.searchArgument(
           std::move(createSearchArgument(predicate, convDict, timezoneInfo)));
     }
+    if (!memory_pool.is_none()) {
+        readerOpts = readerOpts.setMemoryPool(py::cast<PyORCMemoryPool&>(memory_pool));
+        memoryPool = memory_pool;
+    }
+    if (collect_metrics) {
+        metrics = std::make_shared<ReadMetrics>();
+#if ORC_VERSION_AT_LEAST(1, 9, 0)
+        readerOpts = readerOpts.setReaderMetrics(&metrics->orcMetrics);
+#endif
+    }
     reader = orc::createReader(
       std::unique_ptr<orc::InputStream>(new PyORCInputStream(fileo)), readerOpts);
+    batchSize = batch_size;
+    columnar = structKind == 2;
+    if (columnar && reader->getType().getKind() != orc::STRUCT) {
+        throw py::value_error("StructRepr.COLUMNS requires a struct schema");
+    }
+    if (selectsColumns) {
+        /* Validate the column selection right away. */
+        getRowReader();
+    }
+}
+
+orc::RowReader&
+Reader::getRowReader()
+{
+    if (!rowReader) {
+        try {
+            rowReader = reader->createRowReader(rowReaderOpts);
+        } catch (orc::ParseError& err) {
+            throw py::value_error(err.what());
+        }
+    }
+    return *rowReader;
+}
+
+const orc::Type&
+Reader::selectedType()
+{
+    if (!selectsColumns) {
+        return reader->getType();
+    }
+    return getRowReader().getSelectedType();
+}
+
+void
+Reader::prepareRead()
+{
+    if (metadataOnly) {
+        throw py::value_error("Rows cannot be read with a metadata-only reader");
+    }
+    orc::RowReader& rr = getRowReader();
     try {
-        batchSize = batch_size;
-        rowReader = reader->createRowReader(rowReaderOpts);
-        batch = rowReader->createRowBatch(batchSize);
-        converter = createConverter(
-          &rowReader->getSelectedType(), structKind, convDict, timezoneInfo, nullValue);
+        batch = rr.createRowBatch(batchSize);
+        converter = createConverter(&rr.getSelectedType(),
+                                    structKind,
+                                    convDict,
+                                    timezoneInfo,
+                                    nullValue,
+                                    numericArrays);
     } catch (orc::ParseError& err) {
         throw py::value_error(err.what());
     }
@@ -492,19 +652,33 @@ Reader::readStripe(uint64_t idx)
     if (idx >= reader->getNumberOfStripes()) {
         throw py::index_error("stripe index out of range");
     }
-    return std::unique_ptr<Stripe>(new Stripe(*this, idx, reader->getStripe(idx)));
+    uint64_t firstRow = 0;
+    for (uint64_t i = 0; i < idx; ++i) {
+        firstRow += reader->getStripe(i)->getNumberOfRows();
+    }
+    return std::unique_ptr<Stripe>(
+      new Stripe(*this, idx, reader->getStripe(idx), selectedType(), firstRow));
 }
 
 py::object
 Reader::schema()
 {
-    return createTypeDescription(reader->getType());
+    if (!schemaDesc) {
+        schemaDesc = createTypeDescription(reader->getType());
+    }
+    return schemaDesc;
 }
 
 py::object
 Reader::selectedSchema()
 {
-    return createTypeDescription(rowReader->getSelectedType());
+    if (!selectsColumns) {
+        return schema();
+    }
+    if (!selectedSchemaDesc) {
+        selectedSchemaDesc = createTypeDescription(getRowReader().getSelectedType());
+    }
+    return selectedSchemaDesc;
 }
 
 py::tuple
@@ -515,14 +689,381 @@ Reader::statistics(uint64_t columnIndex)
         std::unique_ptr<orc::ColumnStatistics> stats =
           reader->getColumnStatistics(columnIndex);
         result[0] = this->buildStatistics(
-          this->findColumnType(&rowReader->getSelectedType(), columnIndex),
-          stats.get());
+          this->columnType(selectedType(), columnIndex), stats.get());
         return result;
     } catch (std::logic_error& err) {
         throw py::index_error(err.what());
     }
 }
 
+const orc::StripeStatistics&
+Reader::getStripeStatistics(uint64_t idx) const
+{
+    if (stripeStatsCache.empty()) {
+        stripeStatsCache.resize(reader->getNumberOfStripes());
+    }
+    if (!stripeStatsCache[idx]) {
+        stripeStatsCache[idx] = reader->getStripeStatistics(idx);
+    }
+    return *stripeStatsCache[idx];
+}
+
+template <typename T>
+static py::object
+createArray(const char* typecode, const std::vector<T>& values)
+{
+    py::object result = py::module::import("array").attr("array")(typecode);
+    result.attr("frombytes")(py::bytes(reinterpret_cast<const char*>(values.data()),
+                                       values.size() * sizeof(T)));
+    return result;
+}
+
+py::list
+Reader::stripeStatistics(std::vector<uint64_t> columns)
+{
+    uint64_t numOfStripes = reader->getNumberOfStripes();
+    if (reader->getNumberOfStripeStatistics() < numOfStripes) {
+        throw py::value_error("The file does not have stripe statistics");
+    }
+    py::list result;
+    for (uint64_t col : columns) {
+        const orc::Type* type = columnType(selectedType(), col);
+        std::vector<const orc::ColumnStatistics*> stats(numOfStripes);
+        std::vector<uint64_t> numOfValues(numOfStripes);
+        std::vector<uint8_t> hasNull(numOfStripes);
+        for (uint64_t i = 0; i < numOfStripes; ++i) {
+            stats[i] = getStripeStatistics(i).getColumnStatistics(col);
+            numOfValues[i] = stats[i]->getNumberOfValues();
+            hasNull[i] = stats[i]->hasNull();
+        }
+        py::dict colStats;
+        colStats["kind"] = static_cast<int64_t>(type->getKind());
+        colStats["number_of_values"] = createArray("Q", numOfValues);
+        colStats["has_null"] = createArray("B", hasNull);
+        switch (static_cast<int64_t>(type->getKind())) {
+            case orc::BOOLEAN: {
+                std::vector<uint64_t> falseCount(numOfStripes);
+                std::vector<uint64_t> trueCount(numOfStripes);
+                for (uint64_t i = 0; i < numOfStripes; ++i) {
+                    auto* boolStat =
+                      dynamic_cast<const orc::BooleanColumnStatistics*>(stats[i]);
+                    if (boolStat->hasCount()) {
+                        falseCount[i] = boolStat->getFalseCount();
+                        trueCount[i] = boolStat->getTrueCount();
+                    }
+                }
+                colStats["false_count"] = createArray("Q", falseCount);
+                colStats["true_count"] = createArray("Q", trueCount);
+                break;
+            }
+            case orc::BYTE:
+            case orc::INT:
+            case orc::LONG:
+            case orc::SHORT: {
+                std::vector<int64_t> minimum(numOfStripes);
+                std::vector<int64_t> maximum(numOfStripes);
+                std::vector<int64_t> sum(numOfStripes);
+                for (uint64_t i = 0; i < numOfStripes; ++i) {
+                    auto* intStat =
+                      dynamic_cast<const orc::IntegerColumnStatistics*>(stats[i]);
+                    if (intStat->hasMinimum()) {
+                        minimum[i] = intStat->getMinimum();
+                    }
+                    if (intStat->hasMaximum()) {
+                        maximum[i] = intStat->getMaximum();
+                    }
+                    if (intStat->hasSum()) {
+                        sum[i] = intStat->getSum();
+                    }
+                }
+                colStats["minimum"] = createArray("q", minimum);
+                colStats["maximum"] = createArray("q", maximum);
+                colStats["sum"] = createArray("q", sum);
+                break;
+            }
+            case orc::FLOAT:
+            case orc::DOUBLE: {
+                std::vector<double> minimum(numOfStripes);
+                std::vector<double> maximum(numOfStripes);
+                std::vector<double> sum(numOfStripes);
+                for (uint64_t i = 0; i < numOfStripes; ++i) {
+                    auto* doubleStat =
+                      dynamic_cast<const orc::DoubleColumnStatistics*>(stats[i]);
+                    if (doubleStat->hasMinimum()) {
+                        minimum[i] = doubleStat->getMinimum();
+                    }
+                    if (doubleStat->hasMaximum()) {
+                        maximum[i] = doubleStat->getMaximum();
+                    }
+                    if (doubleStat->hasSum()) {
+                        sum[i] = doubleStat->getSum();
+                    }
+                }
+                colStats["minimum"] = createArray("d", minimum);
+                colStats["maximum"] = createArray("d", maximum);
+                colStats["sum"] = createArray("d", sum);
+                break;
+            }
+            default: {
+                /* The bounds of other types are converted to Python objects. */
+                std::vector<py::dict> stripeStats(numOfStripes);
+                for (uint64_t i = 0; i < numOfStripes; ++i) {
+                    stripeStats[i] = buildStatistics(type, stats[i]);
+                }
+                for (const char* key :
+                     { "minimum", "maximum", "sum", "lower_bound", "upper_bound" }) {
+                    bool found = false;
+                    py::list values;
+                    for (uint64_t i = 0; i < numOfStripes; ++i) {
+                        if (stripeStats[i].contains(key)) {
+                            values.append(stripeStats[i][key]);
+                            found = true;
+                        } else {
+                            values.append(py::none());
+                        }
+                    }
+                    if (found) {
+                        colStats[key] = values;
+                    }
+                }
+                bool hasLength = false;
+                std::vector<uint64_t> totalLength(numOfStripes);
+                for (uint64_t i = 0; i < numOfStripes; ++i) {
+                    if (stripeStats[i].contains("total_length")) {
+                        totalLength[i] =
+                          py::cast<uint64_t>(stripeStats[i]["total_length"]);
+                        hasLength = true;
+                    }
+                }
+                if (hasLength) {
+                    colStats["total_length"] = createArray("Q", totalLength);
+                }
+                break;
+            }
+        }
+        result.append(colStats);
+    }
+    return result;
+}
+
+py::dict
+Reader::reduce(uint64_t columnIndex, unsigned int kind, uint64_t bins)
+{
+    return reduceColumn(*reader, columnIndex, kind, bins, batchSize);
+}
+
+py::list
+Reader::take(std::vector<uint64_t> rowNumbers)
+{
+    uint64_t numOfRows = reader->getNumberOfRows();
+    for (uint64_t row : rowNumbers) {
+        if (row >= numOfRows) {
+            std::stringstream errmsg;
+            errmsg << "Row number " << row << " is out of range";
+            throw py::index_error(errmsg.str());
+        }
+    }
+    if (filtersRows) {
+        throw py::value_error("Rows cannot be taken from a reader with a predicate");
+    }
+    if (!converter) {
+        prepareRead();
+    }
+    std::vector<size_t> order(rowNumbers.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        return rowNumbers[lhs] < rowNumbers[rhs];
+    });
+    py::list result(rowNumbers.size());
+    bool loaded = false;
+    uint64_t batchStart = 0;
+    uint64_t batchEnd = 0;
+    for (size_t idx : order) {
+        uint64_t row = rowNumbers[idx];
+        if (!loaded || row >= batchEnd) {
+            /* Keep decoding sequentially when the row is close to the end of
+               the current batch, otherwise jump to its row group. */
+            if (!loaded || row - batchEnd >= batchSize) {
+                rowReader->seekToRow(row);
+            }
+            do {
+                if (!rowReader->next(*batch)) {
+                    throw py::index_error("Row number is out of range");
+                }
+                batchStart = rowReader->getRowNumber();
+                batchEnd = batchStart + batch->numElements;
+            } while (row >= batchEnd);
+            converter->reset(*batch);
+            loaded = true;
+        }
+        result[idx] = convertRow(row - batchStart);
+    }
+    if (loaded) {
+        /* Restore the position of the iteration. */
+        rowReader->seekToRow(currentRow + firstRowOfStripe);
+        batchItem = 0;
+    }
+    return result;
+}
+
+template <typename Pred>
+static uint64_t
+firstNotBefore(uint64_t count, Pred before)
+{
+    uint64_t low = 0;
+    uint64_t high = count;
+    while (low < high) {
+        uint64_t mid = low + (high - low) / 2;
+        if (before(mid)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static std::vector<std::string>
+keyFieldPath(const orc::Type& type, uint64_t columnIndex)
+{
+    std::vector<std::string> path;
+    const orc::Type* current = &type;
+    if (columnIndex > type.getMaximumColumnId()) {
+        throw py::index_error("column not found");
+    }
+    while (current->getColumnId() != columnIndex) {
+        if (current->getKind() != orc::STRUCT) {
+            throw py::value_error("The key column must not be part of a list, "
+                                  "map or union");
+        }
+        size_t idx = 0;
+        while (current->getSubtype(idx)->getMaximumColumnId() < columnIndex) {
+            ++idx;
+        }
+        path.push_back(current->getFieldName(idx));
+        current = current->getSubtype(idx);
+    }
+    if (!isComparableType(*current) || current->getKind() == orc::BOOLEAN ||
+        current->getKind() == orc::BINARY) {
+        std::stringstream errmsg;
+        errmsg << "Cannot seek by column of type " << current->toString();
+        throw py::value_error(errmsg.str());
+    }
+    return path;
+}
+
+uint64_t
+Reader::seekKey(uint64_t columnIndex, py::object value)
+{
+    std::vector<std::string> path = keyFieldPath(reader->getType(), columnIndex);
+    if (!converter) {
+        prepareRead();
+    }
+    const orc::Type* keyType = &rowReader->getSelectedType();
+    orc::ColumnVectorBatch* keyBatch = batch.get();
+    for (const std::string& name : path) {
+        size_t idx = 0;
+        while (idx < keyType->getSubtypeCount() && keyType->getFieldName(idx) != name) {
+            ++idx;
+        }
+        if (idx == keyType->getSubtypeCount()) {
+            throw py::value_error("The key column is not selected");
+        }
+        keyType = keyType->getSubtype(idx);
+        keyBatch = dynamic_cast<orc::StructVectorBatch*>(keyBatch)->fields[idx];
+    }
+    const orc::Type* fileKeyType = findColumnType(&reader->getType(), columnIndex);
+    auto beforeStats = [&](const orc::ColumnStatistics* stats) {
+        py::dict result = buildStatistics(fileKeyType, stats);
+        /* The maximum of timestamps is truncated to milliseconds. */
+        const char* key = result.contains("upper_bound") ? "upper_bound" : "maximum";
+        if (!result.contains(key)) {
+            return true;
+        }
+        py::object maximum = result[key];
+        return maximum < value;
+    };
+
+    /* Find the first row group that might contain the key, assuming that the
+       file is sorted by the column. */
+    uint64_t numOfStripes = reader->getNumberOfStripes();
+    uint64_t startRow = 0;
+    if (reader->getNumberOfStripeStatistics() == numOfStripes) {
+        uint64_t stripeIdx = firstNotBefore(numOfStripes, [&](uint64_t idx) {
+            return beforeStats(
+              getStripeStatistics(idx).getColumnStatistics(columnIndex));
+        });
+        if (stripeIdx == numOfStripes) {
+            return seek(0, 2);
+        }
+        for (uint64_t idx = 0; idx < stripeIdx; ++idx) {
+            startRow += reader->getStripe(idx)->getNumberOfRows();
+        }
+        const orc::StripeStatistics& stripeStats = getStripeStatistics(stripeIdx);
+        uint32_t numOfGroups = stripeStats.getNumberOfRowIndexStats(columnIndex);
+        uint64_t groupIdx = firstNotBefore(numOfGroups, [&](uint64_t idx) {
+            return beforeStats(stripeStats.getRowIndexStatistics(columnIndex, idx));
+        });
+        if (groupIdx < numOfGroups) {
+            startRow += groupIdx * reader->getRowIndexStride();
+        }
+    }
+
+    /* Find the first row of the key in the decoded batches. */
+    std::unique_ptr<Converter> keyConverter =
+      createConverter(keyType, structKind, convDict, timezoneInfo, nullValue);
+    rowReader->seekToRow(startRow);
+    while (rowReader->next(*batch)) {
+        keyConverter->reset(*keyBatch);
+        uint64_t pos = firstNotBefore(batch->numElements, [&](uint64_t idx) {
+            if (keyBatch->hasNulls && !keyBatch->notNull[idx]) {
+                return true;
+            }
+            return keyConverter->toPython(idx) < value;
+        });
+        if (pos < batch->numElements) {
+            uint64_t batchStart = rowReader->getRowNumber();
+            if (pos == 0) {
+                rowReader->seekToRow(batchStart);
+                batchItem = 0;
+            } else {
+                converter->reset(*batch);
+                batchItem = pos;
+            }
+            currentRow = batchStart + pos - firstRowOfStripe;
+            return currentRow;
+        }
+    }
+    return seek(0, 2);
+}
+
+py::object
+Reader::readerMetrics() const
+{
+    if (!metrics) {
+        return py::none();
+    }
+    py::dict res;
+#if ORC_VERSION_AT_LEAST(1, 9, 0)
+    const orc::ReaderMetrics& orcMetrics = metrics->orcMetrics;
+    res["reader_call"] = orcMetrics.ReaderCall.load();
+    res["reader_inclusive_latency_us"] = orcMetrics.ReaderInclusiveLatencyUs.load();
+    res["decompression_call"] = orcMetrics.DecompressionCall.load();
+    res["decompression_latency_us"] = orcMetrics.DecompressionLatencyUs.load();
+    res["decoding_call"] = orcMetrics.DecodingCall.load();
+    res["decoding_latency_us"] = orcMetrics.DecodingLatencyUs.load();
+    res["byte_decoding_call"] = orcMetrics.ByteDecodingCall.load();
+    res["byte_decoding_latency_us"] = orcMetrics.ByteDecodingLatencyUs.load();
+    res["io_count"] = orcMetrics.IOCount.load();
+    res["io_blocking_latency_us"] = orcMetrics.IOBlockingLatencyUs.load();
+    res["selected_row_group_count"] = orcMetrics.SelectedRowGroupCount.load();
+    res["evaluated_row_group_count"] = orcMetrics.EvaluatedRowGroupCount.load();
+#endif
+    res["conversion_call"] = metrics->conversionCall;
+    res["conversion_latency_us"] = metrics->conversionLatencyNs / 1000;
+    return res;
+}
+
 py::dict
 Reader::userMetadata()
 {
@@ -535,26 +1076,45 @@ Reader::userMetadata()
 
 Stripe::Stripe(const Reader& reader_,
                uint64_t idx,
-               std::unique_ptr<orc::StripeInformation> stripe)
+               std::unique_ptr<orc::StripeInformation> stripe,
+               const orc::Type& selectedType_,
+               uint64_t firstRow)
   : reader(reader_)
+  , selectedType(selectedType_)
 {
     batchItem = 0;
     currentRow = 0;
     stripeIndex = idx;
     stripeInfo = std::move(stripe);
+    memoryPool = reader.getMemoryPool();
+    metrics = reader.getMetrics();
     convDict = reader.getConverterDict();
     timezoneInfo = reader.getTimeZoneInfo();
+    columnar = reader.getStructKind() == 2;
     rowReaderOpts = reader.getRowReaderOptions();
     rowReaderOpts =
       rowReaderOpts.range(stripeInfo->getOffset(), stripeInfo->getLength());
-    rowReader = reader.getORCReader().createRowReader(rowReaderOpts);
-    batch = rowReader->createRowBatch(reader.getBatchSize());
-    converter = createConverter(&rowReader->getSelectedType(),
-                                reader.getStructKind(),
-                                convDict,
-                                timezoneInfo,
-                                reader.getNullValue());
-    firstRowOfStripe = rowReader->getRowNumber() + 1;
+    firstRowOfStripe = firstRow;
+}
+
+void
+Stripe::prepareRead()
+{
+    if (reader.isMetadataOnly()) {
+        throw py::value_error("Rows cannot be read with a metadata-only reader");
+    }
+    try {
+        rowReader = reader.getORCReader().createRowReader(rowReaderOpts);
+        batch = rowReader->createRowBatch(reader.getBatchSize());
+        converter = createConverter(&rowReader->getSelectedType(),
+                                    reader.getStructKind(),
+                                    convDict,
+                                    timezoneInfo,
+                                    reader.getNullValue(),
+                                    reader.getNumericArrays());
+    } catch (orc::ParseError& err) {
+        throw py::value_error(err.what());
+    }
 }
 
 py::tuple
@@ -593,19 +1153,16 @@ Stripe::offset() const
 py::tuple
 Stripe::statistics(uint64_t columnIndex)
 {
-    if (columnIndex < 0 ||
-        columnIndex > rowReader->getSelectedType().getMaximumColumnId()) {
+    if (columnIndex < 0 || columnIndex > selectedType.getMaximumColumnId()) {
         throw py::index_error("column index out of range");
     }
-    std::unique_ptr<orc::StripeStatistics> stripeStats =
-      reader.getORCReader().getStripeStatistics(stripeIndex);
-    uint32_t num = stripeStats->getNumberOfRowIndexStats(columnIndex);
+    const orc::StripeStatistics& stripeStats = reader.getStripeStatistics(stripeIndex);
+    const orc::Type* type = this->columnType(selectedType, columnIndex);
+    uint32_t num = stripeStats.getNumberOfRowIndexStats(columnIndex);
     py::tuple result = py::tuple(num);
     for (uint32_t i = 0; i < num; ++i) {
-        const orc::ColumnStatistics* stats =
-          stripeStats->getRowIndexStatistics(columnIndex, i);
         result[i] = this->buildStatistics(
-          this->findColumnType(&rowReader->getSelectedType(), columnIndex), stats);
+          type, stripeStats.getRowIndexStatistics(columnIndex, i));
     }
     return result;
 }
@@ -7,18 +7,30 @@
 #include "orc/OrcFile.hh"
 
 #include "Converter.h"
+#include "verguard.h"
 
 namespace py = pybind11;
 
 py::object
 createTypeDescription(const orc::Type&);
 
+struct ReadMetrics
+{
+#if ORC_VERSION_AT_LEAST(1, 9, 0)
+    orc::ReaderMetrics orcMetrics;
+#endif
+    uint64_t conversionCall = 0;
+    uint64_t conversionLatencyNs = 0;
+};
+
 class ORCFileLikeObject
 {
   private:
     py::object convertTimestampMillis(int64_t) const;
 
   protected:
+    py::object memoryPool;
+    std::shared_ptr<ReadMetrics> metrics;
     uint64_t batchItem;
     orc::RowReaderOptions rowReaderOpts;
     std::unique_ptr<orc::RowReader> rowReader;
@@ -28,17 +40,26 @@ class ORCFileLikeObject
     py::object timezoneInfo;
     py::dict buildStatistics(const orc::Type*, const orc::ColumnStatistics*) const;
     const orc::Type* findColumnType(const orc::Type*, uint64_t) const;
+    std::vector<const orc::Type*> columnTypes;
+    const orc::Type* columnType(const orc::Type&, uint64_t);
+    virtual void prepareRead(){};
+    py::object convertRow(uint64_t);
+    void convertColumns(py::dict, uint64_t, uint64_t);
+    bool columnar = false;
 
   public:
     uint64_t currentRow;
     uint64_t firstRowOfStripe;
     virtual uint64_t len() const = 0;
     py::object next();
-    py::list read(int64_t = -1);
+    py::object read(int64_t = -1);
+    py::object nextBatch();
     uint64_t seek(int64_t, uint16_t = 0);
     const orc::RowReaderOptions getRowReaderOptions() const { return rowReaderOpts; };
     const py::dict getConverterDict() const { return convDict; }
     const py::object getTimeZoneInfo() const { return timezoneInfo; }
+    const py::object getMemoryPool() const { return memoryPool; }
+    const std::shared_ptr<ReadMetrics> getMetrics() const { return metrics; }
     virtual ~ORCFileLikeObject(){};
 };
 
@@ -51,6 +72,18 @@ class Reader : public ORCFileLikeObject
     uint64_t batchSize;
     unsigned int structKind;
     py::object nullValue;
+    bool metadataOnly;
+    bool selectsColumns;
+    bool filtersRows;
+    bool numericArrays;
+    mutable std::vector<std::unique_ptr<orc::StripeStatistics>> stripeStatsCache;
+    py::object schemaDesc;
+    py::object selectedSchemaDesc;
+    orc::RowReader& getRowReader();
+    const orc::Type& selectedType();
+
+  protected:
+    void prepareRead() override;
 
   public:
     Reader(py::object,
@@ -61,7 +94,12 @@ class Reader : public ORCFileLikeObject
            unsigned int = 0,
            py::object = py::none(),
            py::object = py::none(),
-           py::object = py::none());
+           py::object = py::none(),
+           py::object = py::none(),
+           bool = false,
+           bool = false,
+           bool = false,
+           bool = false);
     py::dict bytesLengths() const;
     uint64_t compression() const;
     uint64_t compressionBlockSize() const;
@@ -76,12 +114,20 @@ class Reader : public ORCFileLikeObject
     py::object selectedSchema();
     std::unique_ptr<Stripe> readStripe(uint64_t);
     py::tuple statistics(uint64_t);
+    py::list stripeStatistics(std::vector<uint64_t>);
+    py::dict reduce(uint64_t, unsigned int, uint64_t = 10);
+    py::list take(std::vector<uint64_t>);
+    uint64_t seekKey(uint64_t, py::object);
+    py::object readerMetrics() const;
     py::dict userMetadata();
 
     const orc::Reader& getORCReader() const { return *reader; }
+    const orc::StripeStatistics& getStripeStatistics(uint64_t) const;
     const uint64_t getBatchSize() const { return batchSize; }
     const unsigned int getStructKind() const { return structKind; }
     const py::object getNullValue() const { return nullValue; }
+    const bool getNumericArrays() const { return numericArrays; }
+    const bool isMetadataOnly() const { return metadataOnly; }
     ~Reader(){};
 };
 
@@ -91,9 +137,17 @@ class Stripe : public ORCFileLikeObject
     uint64_t stripeIndex;
     std::unique_ptr<orc::StripeInformation> stripeInfo;
     const Reader& reader;
+    const orc::Type& selectedType;
+
+  protected:
+    void prepareRead() override;
 
   public:
-    Stripe(const Reader&, uint64_t, std::unique_ptr<orc::StripeInformation>);
+    Stripe(const Reader&,
+           uint64_t,
+           std::unique_ptr<orc::StripeInformation>,
+           const orc::Type&,
+           uint64_t);
     py::tuple bloomFilterColumns();
     uint64_t len() const override;
     uint64_t length() const;
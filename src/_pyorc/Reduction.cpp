@@ -0,0 +1,685 @@
+#include <cmath>
+#include <cstring>
+
+#include <pybind11/stl.h>
+
+#include "Reduction.h"
+
+enum ReduceKind
+{
+    REDUCE_COUNT = 0,
+    REDUCE_SUM = 1,
+    REDUCE_HISTOGRAM = 2,
+    REDUCE_DISTINCT = 3
+};
+
+/* Precision of the HyperLogLog sketch for approximate distinct counts. */
+const uint32_t hllPrecision = 14;
+const uint64_t hllRegisters = 1ULL << hllPrecision;
+
+struct Accumulator
+{
+    uint64_t count = 0;
+    orc::Int128 intSum;
+    double doubleSum = 0.0;
+    std::vector<uint64_t> histogram;
+    std::vector<uint8_t> registers;
+};
+
+static inline uint64_t
+mixHash(uint64_t value)
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+static inline uint64_t
+hashInteger(int64_t value)
+{
+    return mixHash(static_cast<uint64_t>(value) + 0x9e3779b97f4a7c15ULL);
+}
+
+static inline uint64_t
+hashBytes(const char* data, uint64_t length)
+{
+    uint64_t hash = hashInteger(static_cast<int64_t>(length));
+    while (length >= 8) {
+        uint64_t chunk;
+        std::memcpy(&chunk, data, 8);
+        hash = mixHash(hash ^ chunk) + 0x9e3779b97f4a7c15ULL;
+        data += 8;
+        length -= 8;
+    }
+    if (length > 0) {
+        uint64_t chunk = 0;
+        std::memcpy(&chunk, data, length);
+        hash = mixHash(hash ^ chunk) + 0x9e3779b97f4a7c15ULL;
+    }
+    return mixHash(hash);
+}
+
+static inline uint32_t
+leadingZeros(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return value == 0 ? 64 : static_cast<uint32_t>(__builtin_clzll(value));
+#else
+    uint32_t count = 0;
+    while (count < 64 && (value & (1ULL << 63)) == 0) {
+        value <<= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+static inline void
+addHash(uint8_t* registers, uint64_t hash)
+{
+    uint64_t idx = hash >> (64 - hllPrecision);
+    uint64_t rest = (hash << hllPrecision) | (1ULL << (hllPrecision - 1));
+    uint8_t rank = static_cast<uint8_t>(leadingZeros(rest) + 1);
+    if (rank > registers[idx]) {
+        registers[idx] = rank;
+    }
+}
+
+static uint64_t
+estimateDistinct(const std::vector<uint8_t>& registers)
+{
+    const double m = static_cast<double>(registers.size());
+    double sum = 0.0;
+    uint64_t zeros = 0;
+    for (uint8_t reg : registers) {
+        sum += std::ldexp(1.0, -static_cast<int>(reg));
+        if (reg == 0) {
+            ++zeros;
+        }
+    }
+    double estimate = (0.7213 / (1.0 + 1.079 / m)) * m * m / sum;
+    if (estimate <= 2.5 * m && zeros != 0) {
+        /* Linear counting is more accurate for small cardinalities. */
+        estimate = m * std::log(m / static_cast<double>(zeros));
+    }
+    return static_cast<uint64_t>(std::llround(estimate));
+}
+
+static uint64_t
+countNotNull(const orc::ColumnVectorBatch& batch)
+{
+    if (!batch.hasNulls) {
+        return batch.numElements;
+    }
+    const char* notNull = batch.notNull.data();
+    uint64_t count = 0;
+    for (uint64_t i = 0; i < batch.numElements; ++i) {
+        count += static_cast<uint64_t>(notNull[i] != 0);
+    }
+    return count;
+}
+
+template <typename T>
+void
+sumIntegers(const T* data, const char* notNull, uint64_t numElements, orc::Int128& sum)
+{
+    /* Sum the upper and lower 32 bits separately: neither partial sum can
+       overflow within a batch and the loop stays free of branches. */
+    int64_t high = 0;
+    uint64_t low = 0;
+    if (notNull == nullptr) {
+        for (uint64_t i = 0; i < numElements; ++i) {
+            int64_t value = static_cast<int64_t>(data[i]);
+            high += value >> 32;
+            low += static_cast<uint32_t>(value);
+        }
+    } else {
+        for (uint64_t i = 0; i < numElements; ++i) {
+            int64_t value = notNull[i] ? static_cast<int64_t>(data[i]) : 0;
+            high += value >> 32;
+            low += static_cast<uint32_t>(value);
+        }
+    }
+    orc::Int128 partial(high);
+    partial <<= 32;
+    partial += orc::Int128(0, low);
+    sum += partial;
+}
+
+template <typename T>
+void
+sumFloats(const T* data, const char* notNull, uint64_t numElements, double& sum)
+{
+    double lanes[4] = { 0.0, 0.0, 0.0, 0.0 };
+    uint64_t i = 0;
+    if (notNull == nullptr) {
+        for (; i + 4 <= numElements; i += 4) {
+            lanes[0] += data[i];
+            lanes[1] += data[i + 1];
+            lanes[2] += data[i + 2];
+            lanes[3] += data[i + 3];
+        }
+        for (; i < numElements; ++i) {
+            lanes[0] += data[i];
+        }
+    } else {
+        for (; i + 4 <= numElements; i += 4) {
+            lanes[0] += notNull[i] ? data[i] : 0.0;
+            lanes[1] += notNull[i + 1] ? data[i + 1] : 0.0;
+            lanes[2] += notNull[i + 2] ? data[i + 2] : 0.0;
+            lanes[3] += notNull[i + 3] ? data[i + 3] : 0.0;
+        }
+        for (; i < numElements; ++i) {
+            lanes[0] += notNull[i] ? data[i] : 0.0;
+        }
+    }
+    sum += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+template <typename T>
+void
+histogramValues(const T* data,
+                const char* notNull,
+                uint64_t numElements,
+                double lower,
+                double scale,
+                std::vector<uint64_t>& counts)
+{
+    const uint64_t last = counts.size() - 1;
+    const double lastPos = static_cast<double>(last);
+    for (uint64_t i = 0; i < numElements; ++i) {
+        if (notNull != nullptr && !notNull[i]) {
+            continue;
+        }
+        double pos = (static_cast<double>(data[i]) - lower) * scale;
+        if (std::isnan(pos)) {
+            continue;
+        }
+        uint64_t bin = 0;
+        if (pos >= lastPos) {
+            bin = last;
+        } else if (pos > 0.0) {
+            bin = static_cast<uint64_t>(pos);
+        }
+        ++counts[bin];
+    }
+}
+
+template <typename T>
+void
+boundValues(const T* data,
+            const char* notNull,
+            uint64_t numElements,
+            bool& found,
+            double& lower,
+            double& upper)
+{
+    for (uint64_t i = 0; i < numElements; ++i) {
+        if (notNull != nullptr && !notNull[i]) {
+            continue;
+        }
+        double value = static_cast<double>(data[i]);
+        if (std::isnan(value)) {
+            continue;
+        }
+        if (!found) {
+            lower = value;
+            upper = value;
+            found = true;
+        } else if (value < lower) {
+            lower = value;
+        } else if (value > upper) {
+            upper = value;
+        }
+    }
+}
+
+template <typename T>
+void
+distinctIntegers(const T* data,
+                 const char* notNull,
+                 uint64_t numElements,
+                 uint8_t* registers)
+{
+    for (uint64_t i = 0; i < numElements; ++i) {
+        if (notNull == nullptr || notNull[i]) {
+            addHash(registers, hashInteger(static_cast<int64_t>(data[i])));
+        }
+    }
+}
+
+template <typename T>
+void
+distinctFloats(const T* data,
+               const char* notNull,
+               uint64_t numElements,
+               uint8_t* registers)
+{
+    for (uint64_t i = 0; i < numElements; ++i) {
+        if (notNull == nullptr || notNull[i]) {
+            double value = static_cast<double>(data[i]);
+            if (value == 0.0) {
+                /* Make -0.0 and 0.0 hash the same. */
+                value = 0.0;
+            }
+            int64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            addHash(registers, hashInteger(bits));
+        }
+    }
+}
+
+static const orc::Type*
+findSubtype(const orc::Type& type, uint64_t columnIndex)
+{
+    if (type.getColumnId() == columnIndex) {
+        return &type;
+    }
+    for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+        const orc::Type* subtype = type.getSubtype(i);
+        if (subtype->getColumnId() <= columnIndex &&
+            subtype->getMaximumColumnId() >= columnIndex) {
+            return findSubtype(*subtype, columnIndex);
+        }
+    }
+    throw py::index_error("column not found");
+}
+
+static const orc::ColumnVectorBatch*
+findColumnBatch(const orc::Type& type,
+                const orc::ColumnVectorBatch& batch,
+                uint64_t columnIndex)
+{
+    if (type.getColumnId() == columnIndex) {
+        return &batch;
+    }
+    for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+        const orc::Type* subtype = type.getSubtype(i);
+        if (subtype->getColumnId() > columnIndex ||
+            subtype->getMaximumColumnId() < columnIndex) {
+            continue;
+        }
+        switch (static_cast<int64_t>(type.getKind())) {
+            case orc::LIST: {
+                const auto& listBatch =
+                  dynamic_cast<const orc::ListVectorBatch&>(batch);
+                return findColumnBatch(*subtype, *listBatch.elements, columnIndex);
+            }
+            case orc::MAP: {
+                const auto& mapBatch = dynamic_cast<const orc::MapVectorBatch&>(batch);
+                return findColumnBatch(
+                  *subtype, i == 0 ? *mapBatch.keys : *mapBatch.elements, columnIndex);
+            }
+            case orc::UNION: {
+                const auto& unionBatch =
+                  dynamic_cast<const orc::UnionVectorBatch&>(batch);
+                return findColumnBatch(*subtype, *unionBatch.children[i], columnIndex);
+            }
+            default: {
+                const auto& structBatch =
+                  dynamic_cast<const orc::StructVectorBatch&>(batch);
+                return findColumnBatch(*subtype, *structBatch.fields[i], columnIndex);
+            }
+        }
+    }
+    throw py::index_error("column not found");
+}
+
+class ColumnReducer
+{
+  private:
+    int64_t typeKind;
+    unsigned int kind;
+    uint64_t bins;
+    double lower;
+    double upper;
+    bool hasBounds;
+    void updateDistinct(const orc::ColumnVectorBatch&, const char*, uint8_t*) const;
+
+  public:
+    ColumnReducer(const orc::Type&,
+                  unsigned int,
+                  uint64_t,
+                  const orc::ColumnStatistics*);
+    bool needsBounds() const;
+    void updateBounds(const orc::ColumnVectorBatch&);
+    Accumulator create() const;
+    void update(const orc::ColumnVectorBatch&, Accumulator&) const;
+    void merge(const Accumulator&, Accumulator&) const;
+    py::object result(const Accumulator&) const;
+    py::list binEdges() const;
+};
+
+ColumnReducer::ColumnReducer(const orc::Type& type,
+                             unsigned int kind_,
+                             uint64_t bins_,
+                             const orc::ColumnStatistics* stats)
+  : typeKind(static_cast<int64_t>(type.getKind()))
+  , kind(kind_)
+  , bins(bins_)
+  , lower(0.0)
+  , upper(0.0)
+  , hasBounds(false)
+{
+    bool supported = true;
+    switch (kind) {
+        case REDUCE_COUNT:
+            break;
+        case REDUCE_SUM:
+            supported = (typeKind == orc::BOOLEAN || typeKind == orc::BYTE ||
+                         typeKind == orc::SHORT || typeKind == orc::INT ||
+                         typeKind == orc::LONG || typeKind == orc::FLOAT ||
+                         typeKind == orc::DOUBLE);
+            break;
+        case REDUCE_HISTOGRAM: {
+            if (bins == 0) {
+                throw py::value_error("The number of bins must be positive");
+            }
+            if (typeKind == orc::BYTE || typeKind == orc::SHORT ||
+                typeKind == orc::INT || typeKind == orc::LONG) {
+                auto* intStat =
+                  dynamic_cast<const orc::IntegerColumnStatistics*>(stats);
+                if (intStat != nullptr && intStat->hasMinimum() &&
+                    intStat->hasMaximum()) {
+                    lower = static_cast<double>(intStat->getMinimum());
+                    upper = static_cast<double>(intStat->getMaximum());
+                    hasBounds = true;
+                }
+            } else if (typeKind == orc::FLOAT || typeKind == orc::DOUBLE) {
+                auto* doubleStat =
+                  dynamic_cast<const orc::DoubleColumnStatistics*>(stats);
+                if (doubleStat != nullptr && doubleStat->hasMinimum() &&
+                    doubleStat->hasMaximum()) {
+                    lower = doubleStat->getMinimum();
+                    upper = doubleStat->getMaximum();
+                    hasBounds = !std::isnan(lower) && !std::isnan(upper);
+                }
+            } else {
+                supported = false;
+            }
+            break;
+        }
+        case REDUCE_DISTINCT:
+            supported = (typeKind != orc::LIST && typeKind != orc::MAP &&
+                         typeKind != orc::STRUCT && typeKind != orc::UNION);
+            break;
+        default:
+            throw py::value_error("Invalid reduce kind");
+    }
+    if (!supported) {
+        throw py::type_error("Reduce kind is not supported for the column's type");
+    }
+}
+
+bool
+ColumnReducer::needsBounds() const
+{
+    return kind == REDUCE_HISTOGRAM && !hasBounds;
+}
+
+void
+ColumnReducer::updateBounds(const orc::ColumnVectorBatch& batch)
+{
+    const char* notNull = batch.hasNulls ? batch.notNull.data() : nullptr;
+    uint64_t num = batch.numElements;
+    bool found = hasBounds;
+    if (typeKind == orc::FLOAT || typeKind == orc::DOUBLE) {
+        const auto& doubleBatch = dynamic_cast<const orc::DoubleVectorBatch&>(batch);
+        boundValues(doubleBatch.data.data(), notNull, num, found, lower, upper);
+    } else {
+        const auto& longBatch = dynamic_cast<const orc::LongVectorBatch&>(batch);
+        boundValues(longBatch.data.data(), notNull, num, found, lower, upper);
+    }
+    hasBounds = found;
+}
+
+Accumulator
+ColumnReducer::create() const
+{
+    Accumulator acc;
+    if (kind == REDUCE_HISTOGRAM) {
+        acc.histogram.assign(bins, 0);
+    } else if (kind == REDUCE_DISTINCT) {
+        acc.registers.assign(hllRegisters, 0);
+    }
+    return acc;
+}
+
+void
+ColumnReducer::update(const orc::ColumnVectorBatch& batch, Accumulator& acc) const
+{
+    const char* notNull = batch.hasNulls ? batch.notNull.data() : nullptr;
+    uint64_t num = batch.numElements;
+    switch (kind) {
+        case REDUCE_COUNT:
+            acc.count += countNotNull(batch);
+            return;
+        case REDUCE_SUM:
+            if (typeKind == orc::FLOAT || typeKind == orc::DOUBLE) {
+                const auto& doubleBatch =
+                  dynamic_cast<const orc::DoubleVectorBatch&>(batch);
+                sumFloats(doubleBatch.data.data(), notNull, num, acc.doubleSum);
+            } else {
+                const auto& longBatch =
+                  dynamic_cast<const orc::LongVectorBatch&>(batch);
+                sumIntegers(longBatch.data.data(), notNull, num, acc.intSum);
+            }
+            return;
+        case REDUCE_HISTOGRAM: {
+            double scale =
+              upper > lower ? static_cast<double>(bins) / (upper - lower) : 0.0;
+            if (typeKind == orc::FLOAT || typeKind == orc::DOUBLE) {
+                const auto& doubleBatch =
+                  dynamic_cast<const orc::DoubleVectorBatch&>(batch);
+                histogramValues(
+                  doubleBatch.data.data(), notNull, num, lower, scale, acc.histogram);
+            } else {
+                const auto& longBatch =
+                  dynamic_cast<const orc::LongVectorBatch&>(batch);
+                histogramValues(
+                  longBatch.data.data(), notNull, num, lower, scale, acc.histogram);
+            }
+            return;
+        }
+        case REDUCE_DISTINCT:
+            updateDistinct(batch, notNull, acc.registers.data());
+            return;
+        default:
+            return;
+    }
+}
+
+void
+ColumnReducer::updateDistinct(const orc::ColumnVectorBatch& batch,
+                              const char* notNull,
+                              uint8_t* registers) const
+{
+    uint64_t num = batch.numElements;
+    switch (typeKind) {
+        case orc::FLOAT:
+        case orc::DOUBLE: {
+            const auto& doubleBatch =
+              dynamic_cast<const orc::DoubleVectorBatch&>(batch);
+            distinctFloats(doubleBatch.data.data(), notNull, num, registers);
+            return;
+        }
+        case orc::STRING:
+        case orc::VARCHAR:
+        case orc::CHAR:
+        case orc::BINARY: {
+            const auto& strBatch = dynamic_cast<const orc::StringVectorBatch&>(batch);
+            for (uint64_t i = 0; i < num; ++i) {
+                if (notNull == nullptr || notNull[i]) {
+                    uint64_t length = static_cast<uint64_t>(strBatch.length[i]);
+                    addHash(registers, hashBytes(strBatch.data[i], length));
+                }
+            }
+            return;
+        }
+        case orc::TIMESTAMP:
+        case orc::TIMESTAMP_INSTANT: {
+            const auto& tsBatch = dynamic_cast<const orc::TimestampVectorBatch&>(batch);
+            for (uint64_t i = 0; i < num; ++i) {
+                if (notNull == nullptr || notNull[i]) {
+                    uint64_t hash = hashInteger(tsBatch.data[i]) ^
+                                    static_cast<uint64_t>(tsBatch.nanoseconds[i]);
+                    addHash(registers, mixHash(hash));
+                }
+            }
+            return;
+        }
+        case orc::DECIMAL: {
+            auto* dec64Batch = dynamic_cast<const orc::Decimal64VectorBatch*>(&batch);
+            if (dec64Batch != nullptr) {
+                distinctIntegers(dec64Batch->values.data(), notNull, num, registers);
+                return;
+            }
+            const auto& dec128Batch =
+              dynamic_cast<const orc::Decimal128VectorBatch&>(batch);
+            for (uint64_t i = 0; i < num; ++i) {
+                if (notNull == nullptr || notNull[i]) {
+                    const orc::Int128& value = dec128Batch.values[i];
+                    uint64_t hash =
+                      hashInteger(value.getHighBits()) ^ value.getLowBits();
+                    addHash(registers, mixHash(hash));
+                }
+            }
+            return;
+        }
+        default: {
+            const auto& longBatch = dynamic_cast<const orc::LongVectorBatch&>(batch);
+            distinctIntegers(longBatch.data.data(), notNull, num, registers);
+            return;
+        }
+    }
+}
+
+void
+ColumnReducer::merge(const Accumulator& from, Accumulator& to) const
+{
+    to.count += from.count;
+    to.intSum += from.intSum;
+    to.doubleSum += from.doubleSum;
+    for (size_t i = 0; i < from.histogram.size(); ++i) {
+        to.histogram[i] += from.histogram[i];
+    }
+    for (size_t i = 0; i < from.registers.size(); ++i) {
+        if (from.registers[i] > to.registers[i]) {
+            to.registers[i] = from.registers[i];
+        }
+    }
+}
+
+py::object
+ColumnReducer::result(const Accumulator& acc) const
+{
+    switch (kind) {
+        case REDUCE_SUM:
+            if (typeKind == orc::FLOAT || typeKind == orc::DOUBLE) {
+                return py::float_(acc.doubleSum);
+            }
+            return py::int_(py::str(acc.intSum.toString()));
+        case REDUCE_HISTOGRAM:
+            return py::cast(acc.histogram);
+        case REDUCE_DISTINCT:
+            return py::int_(estimateDistinct(acc.registers));
+        default:
+            return py::int_(acc.count);
+    }
+}
+
+py::list
+ColumnReducer::binEdges() const
+{
+    py::list result;
+    double width = (upper - lower) / static_cast<double>(bins);
+    for (uint64_t i = 0; i <= bins; ++i) {
+        result.append(py::float_(lower + width * static_cast<double>(i)));
+    }
+    return result;
+}
+
+py::dict
+reduceColumn(const orc::Reader& reader,
+             uint64_t columnIndex,
+             unsigned int kind,
+             uint64_t bins,
+             uint64_t batchSize)
+{
+    const orc::Type& fileType = reader.getType();
+    if (columnIndex > fileType.getMaximumColumnId()) {
+        throw py::index_error("column index out of range");
+    }
+    orc::RowReaderOptions rowReaderOpts;
+    const orc::Type* fieldType = nullptr;
+    if (columnIndex != 0 && fileType.getKind() == orc::STRUCT) {
+        /* Decode only the top-level field that contains the column. */
+        for (uint64_t i = 0; i < fileType.getSubtypeCount(); ++i) {
+            const orc::Type* subtype = fileType.getSubtype(i);
+            if (subtype->getColumnId() <= columnIndex &&
+                subtype->getMaximumColumnId() >= columnIndex) {
+                rowReaderOpts = rowReaderOpts.include(std::list<uint64_t>{ i });
+                fieldType = subtype;
+                break;
+            }
+        }
+    }
+    std::unique_ptr<orc::ColumnStatistics> stats =
+      reader.getColumnStatistics(static_cast<uint32_t>(columnIndex));
+    ColumnReducer reducer(
+      *findSubtype(fileType, columnIndex), kind, bins, stats.get());
+
+    std::vector<uint64_t> stripeStarts;
+    uint64_t rows = 0;
+    for (uint64_t i = 0; i < reader.getNumberOfStripes(); ++i) {
+        stripeStarts.push_back(rows);
+        rows += reader.getStripe(i)->getNumberOfRows();
+    }
+    std::vector<Accumulator> stripeAccs(stripeStarts.size(), reducer.create());
+
+    auto columnBatch = [&](const orc::ColumnVectorBatch& batch) {
+        if (fieldType != nullptr) {
+            const auto& root = dynamic_cast<const orc::StructVectorBatch&>(batch);
+            return findColumnBatch(*fieldType, *root.fields[0], columnIndex);
+        }
+        return findColumnBatch(fileType, batch, columnIndex);
+    };
+    std::unique_ptr<orc::RowReader> rowReader = reader.createRowReader(rowReaderOpts);
+    std::unique_ptr<orc::ColumnVectorBatch> batch =
+      rowReader->createRowBatch(batchSize);
+    if (reducer.needsBounds()) {
+        /* Without minimum and maximum in the file statistics, the bounds of
+           the histogram are calculated with an extra pass over the column. */
+        while (rowReader->next(*batch)) {
+            reducer.updateBounds(*columnBatch(*batch));
+        }
+        rowReader->seekToRow(0);
+    }
+    size_t stripe = 0;
+    /* A batch never spans over multiple stripes. */
+    while (rowReader->next(*batch)) {
+        uint64_t rowNumber = rowReader->getRowNumber();
+        while (stripe + 1 < stripeStarts.size() &&
+               rowNumber >= stripeStarts[stripe + 1]) {
+            ++stripe;
+        }
+        reducer.update(*columnBatch(*batch), stripeAccs[stripe]);
+    }
+
+    py::dict result;
+    py::list stripeResults;
+    Accumulator total = reducer.create();
+    for (const Accumulator& acc : stripeAccs) {
+        reducer.merge(acc, total);
+        stripeResults.append(reducer.result(acc));
+    }
+    result["file"] = reducer.result(total);
+    result["stripes"] = stripeResults;
+    if (kind == REDUCE_HISTOGRAM) {
+        result["bin_edges"] = reducer.binEdges();
+    }
+    return result;
+}
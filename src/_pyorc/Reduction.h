@@ -0,0 +1,13 @@
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include <pybind11/pybind11.h>
+
+#include "orc/OrcFile.hh"
+
+namespace py = pybind11;
+
+py::dict
+reduceColumn(const orc::Reader&, uint64_t, unsigned int, uint64_t, uint64_t);
+
+#endif
@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <sstream>
+
+#include "MemoryPool.h"
+#include "PyORCStream.h"
+#include "Sort.h"
+#include "VectorBatch.h"
+
+class RowComparator
+{
+  private:
+    const orc::Type& type;
+    const std::vector<uint64_t>& keys;
+
+  public:
+    RowComparator(const orc::Type& type, const std::vector<uint64_t>& keys)
+      : type(type)
+      , keys(keys)
+    {}
+    int compare(const orc::ColumnVectorBatch& left,
+                uint64_t leftRow,
+                const orc::ColumnVectorBatch& right,
+                uint64_t rightRow) const
+    {
+        const auto& lhs = static_cast<const orc::StructVectorBatch&>(left);
+        const auto& rhs = static_cast<const orc::StructVectorBatch&>(right);
+        for (uint64_t key : keys) {
+            int res = compareRows(*type.getSubtype(key),
+                                  *lhs.fields[key],
+                                  leftRow,
+                                  *rhs.fields[key],
+                                  rightRow);
+            if (res != 0) {
+                return res;
+            }
+        }
+        return 0;
+    }
+};
+
+/* The minimum number of batches in a spilled run, regardless of the memory
+   limit, to keep the number of runs reasonable. */
+const uint64_t minRunBatches = 16;
+
+/* The maximum number of runs that are merged at once. More runs are merged
+   in multiple passes into intermediate runs. */
+const size_t mergeFanIn = 64;
+
+/* A sorted run that is read back for merging. */
+struct RunCursor
+{
+    std::unique_ptr<orc::Reader> reader;
+    std::unique_ptr<orc::RowReader> rowReader;
+    std::unique_ptr<orc::ColumnVectorBatch> batch;
+    uint64_t row;
+};
+
+/* A temporary ORC file of a sorted run. */
+struct RunFile
+{
+    std::unique_ptr<orc::OutputStream> outStream;
+    std::unique_ptr<orc::Writer> writer;
+
+    RunFile(const orc::Type& type, const std::string& path, orc::MemoryPool* pool)
+    {
+        /* The runs are read back only once, a fast compression is enough. */
+        orc::WriterOptions options;
+        options = options.setCompression(orc::CompressionKind_LZ4);
+        options = options.setMemoryPool(pool);
+        outStream = orc::writeLocalFile(path);
+        writer = orc::createWriter(type, outStream.get(), options);
+    }
+};
+
+static std::vector<uint64_t>
+sortedOrder(const RowComparator& comparator, const orc::ColumnVectorBatch& run)
+{
+    std::vector<uint64_t> order(run.numElements);
+    std::iota(order.begin(), order.end(), 0);
+    py::gil_scoped_release gil;
+    std::stable_sort(order.begin(), order.end(), [&](uint64_t lhs, uint64_t rhs) {
+        return comparator.compare(run, lhs, run, rhs) < 0;
+    });
+    return order;
+}
+
+static void
+spillRun(const orc::Type& type,
+         const orc::ColumnVectorBatch& run,
+         const std::vector<uint64_t>& order,
+         const std::string& path,
+         orc::MemoryPool* pool,
+         uint64_t batchSize)
+{
+    py::gil_scoped_release gil;
+    RunFile file(type, path, pool);
+    std::unique_ptr<orc::ColumnVectorBatch> batch =
+      file.writer->createRowBatch(batchSize);
+    for (uint64_t start = 0; start < order.size(); start += batchSize) {
+        uint64_t end = std::min(start + batchSize, static_cast<uint64_t>(order.size()));
+        resetBatch(type, *batch);
+        for (uint64_t i = start; i < end; ++i) {
+            copyRow(type, run, order[i], *batch);
+        }
+        file.writer->add(*batch);
+    }
+    file.writer->close();
+}
+
+/* Merges the sorted runs into full batches, that are passed to the sink.
+   The string values are copied into an arena, therefore the merged batch
+   does not depend on the batches of the runs, that are overwritten when
+   the next batch of a run is read. */
+template <typename Sink>
+static void
+mergeRuns(const orc::Type& type,
+          const RowComparator& comparator,
+          const std::vector<std::string>& paths,
+          const orc::ReaderOptions& readerOpts,
+          uint64_t batchSize,
+          Sink sink)
+{
+    std::vector<RunCursor> cursors(paths.size());
+    std::vector<size_t> heap;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        RunCursor& cursor = cursors[i];
+        cursor.reader = orc::createReader(orc::readLocalFile(paths[i]), readerOpts);
+        cursor.rowReader = cursor.reader->createRowReader();
+        cursor.batch = cursor.rowReader->createRowBatch(batchSize);
+        cursor.row = 0;
+        if (cursor.rowReader->next(*cursor.batch)) {
+            heap.push_back(i);
+        }
+    }
+    if (heap.empty()) {
+        return;
+    }
+    std::unique_ptr<orc::ColumnVectorBatch> merged =
+      cursors[0].rowReader->createRowBatch(batchSize);
+    resetBatch(type, *merged);
+    StringArena arena(readerOpts.getMemoryPool());
+    /* A min-heap of the runs by their current rows. The earlier run comes
+       first on equal keys to keep the sort stable. */
+    auto greater = [&](size_t lhs, size_t rhs) {
+        int res = comparator.compare(*cursors[lhs].batch,
+                                     cursors[lhs].row,
+                                     *cursors[rhs].batch,
+                                     cursors[rhs].row);
+        return res != 0 ? res > 0 : lhs > rhs;
+    };
+    std::make_heap(heap.begin(), heap.end(), greater);
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), greater);
+        RunCursor& cursor = cursors[heap.back()];
+        copyRow(type, *cursor.batch, cursor.row, *merged, &arena);
+        if (merged->numElements == batchSize) {
+            sink(*merged);
+            resetBatch(type, *merged);
+            arena.clear();
+        }
+        if (++cursor.row == cursor.batch->numElements) {
+            cursor.row = 0;
+            if (!cursor.rowReader->next(*cursor.batch)) {
+                heap.pop_back();
+                continue;
+            }
+        }
+        std::push_heap(heap.begin(), heap.end(), greater);
+    }
+    if (merged->numElements > 0) {
+        sink(*merged);
+    }
+}
+
+uint64_t
+sortFiles(py::list inputs,
+          Writer& output,
+          std::vector<uint64_t> keys,
+          uint64_t memoryLimit,
+          const std::string& tmpPrefix,
+          uint64_t batchSize)
+{
+    const orc::Type& type = output.schemaType();
+    if (type.getKind() != orc::TypeKind::STRUCT) {
+        throw py::type_error("Sorting rows requires a struct schema");
+    }
+    checkSortKeys(type, keys);
+    RowComparator comparator(type, keys);
+    PyORCMemoryPool pool;
+    orc::ReaderOptions readerOpts;
+    readerOpts = readerOpts.setMemoryPool(pool);
+    StringArena arena(&pool);
+    std::unique_ptr<orc::ColumnVectorBatch> run;
+    std::vector<std::string> runPaths;
+    uint64_t runCount = 0;
+    uint64_t rows = 0;
+
+    auto nextRunPath = [&]() {
+        return tmpPrefix + std::to_string(runCount++) + ".orc";
+    };
+    auto spill = [&]() {
+        std::string path = nextRunPath();
+        spillRun(type, *run, sortedOrder(comparator, *run), path, &pool, batchSize);
+        runPaths.push_back(path);
+        /* Release the memory of the run, instead of keeping it for reuse. */
+        run.reset();
+        arena = StringArena(&pool);
+    };
+
+    for (size_t idx = 0; idx < inputs.size(); ++idx) {
+        std::unique_ptr<orc::Reader> reader = orc::createReader(
+          std::unique_ptr<orc::InputStream>(new PyORCInputStream(inputs[idx])),
+          readerOpts);
+        if (reader->getType().toString() != type.toString()) {
+            std::stringstream errmsg;
+            errmsg << "The schema of input " << idx << " ("
+                   << reader->getType().toString()
+                   << ") does not match the output schema";
+            throw py::value_error(errmsg.str());
+        }
+        std::unique_ptr<orc::RowReader> rowReader = reader->createRowReader();
+        std::unique_ptr<orc::ColumnVectorBatch> batch =
+          rowReader->createRowBatch(batchSize);
+        while (rowReader->next(*batch)) {
+            if (!run) {
+                run = rowReader->createRowBatch(batchSize);
+                resetBatch(type, *run);
+            }
+            /* The batch is overwritten by the next read, the string values
+               must be copied. */
+            for (uint64_t row = 0; row < batch->numElements; ++row) {
+                copyRow(type, *batch, row, *run, &arena);
+            }
+            rows += batch->numElements;
+            if (pool.getLiveBytes() >= memoryLimit &&
+                run->numElements >= minRunBatches * batchSize) {
+                spill();
+            }
+        }
+    }
+    if (runPaths.empty()) {
+        /* Everything fits into the memory, no merge is needed. */
+        if (run) {
+            for (uint64_t row : sortedOrder(comparator, *run)) {
+                output.appendRow(*run, row);
+            }
+        }
+        output.flushRows();
+        return rows;
+    }
+    if (run) {
+        spill();
+    }
+
+    while (runPaths.size() > mergeFanIn) {
+        std::vector<std::string> mergedPaths;
+        for (size_t start = 0; start < runPaths.size(); start += mergeFanIn) {
+            size_t end = std::min(start + mergeFanIn, runPaths.size());
+            if (end - start == 1) {
+                mergedPaths.push_back(runPaths[start]);
+                continue;
+            }
+            std::vector<std::string> group(runPaths.begin() + start,
+                                           runPaths.begin() + end);
+            std::string path = nextRunPath();
+            {
+                py::gil_scoped_release gil;
+                RunFile file(type, path, &pool);
+                mergeRuns(type,
+                          comparator,
+                          group,
+                          readerOpts,
+                          batchSize,
+                          [&](orc::ColumnVectorBatch& batch) {
+                              file.writer->add(batch);
+                          });
+                file.writer->close();
+            }
+            for (const std::string& groupPath : group) {
+                std::remove(groupPath.c_str());
+            }
+            mergedPaths.push_back(path);
+        }
+        runPaths = mergedPaths;
+    }
+    mergeRuns(type,
+              comparator,
+              runPaths,
+              readerOpts,
+              batchSize,
+              [&](orc::ColumnVectorBatch& batch) { output.addNativeBatch(batch); });
+    output.flushRows();
+    return rows;
+}
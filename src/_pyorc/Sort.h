@@ -0,0 +1,25 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "Writer.h"
+
+namespace py = pybind11;
+
+/* Sorts the rows of ORC files (binary file-like objects) by top-level
+   fields into the writer with an external merge sort. The rows are copied
+   natively into a run until the memory limit is reached, then the sorted run
+   is spilled into a temporary ORC file, named by the prefix. The runs are
+   merged at the end, in multiple passes if there are too many of them.
+   Returns the number of written rows. */
+uint64_t
+sortFiles(py::list,
+          Writer&,
+          std::vector<uint64_t>,
+          uint64_t,
+          const std::string&,
+          uint64_t = 1024);
+
+#endif
@@ -0,0 +1,415 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#include <pybind11/pybind11.h>
+
+#include "VectorBatch.h"
+
+namespace py = pybind11;
+
+void
+StringArena::BlockDeleter::operator()(char* block) const
+{
+    if (pool != nullptr) {
+        pool->free(block);
+    } else {
+        delete[] block;
+    }
+}
+
+StringArena::Block
+StringArena::allocate(size_t size)
+{
+    char* block = pool != nullptr ? pool->malloc(size) : new char[size];
+    return Block(block, BlockDeleter{ pool });
+}
+
+char*
+StringArena::copy(const char* src, size_t length)
+{
+    char* dest;
+    if (length > chunkSize / 4) {
+        largeBlocks.push_back(allocate(length));
+        dest = largeBlocks.back().get();
+    } else {
+        if (chunks.empty() || used + length > chunkSize) {
+            if (!chunks.empty()) {
+                ++current;
+            }
+            if (current == chunks.size()) {
+                chunks.push_back(allocate(chunkSize));
+            }
+            used = 0;
+        }
+        dest = chunks[current].get() + used;
+        used += length;
+    }
+    std::memcpy(dest, src, length);
+    return dest;
+}
+
+void
+StringArena::clear()
+{
+    largeBlocks.clear();
+    current = 0;
+    used = 0;
+}
+
+bool
+isComparableType(const orc::Type& type)
+{
+    switch (static_cast<int64_t>(type.getKind())) {
+        case orc::BOOLEAN:
+        case orc::BYTE:
+        case orc::SHORT:
+        case orc::INT:
+        case orc::LONG:
+        case orc::DATE:
+        case orc::FLOAT:
+        case orc::DOUBLE:
+        case orc::STRING:
+        case orc::VARCHAR:
+        case orc::CHAR:
+        case orc::BINARY:
+        case orc::TIMESTAMP:
+        case orc::TIMESTAMP_INSTANT:
+        case orc::DECIMAL:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void
+checkSortKeys(const orc::Type& type, const std::vector<uint64_t>& keys)
+{
+    for (uint64_t key : keys) {
+        if (key >= type.getSubtypeCount()) {
+            std::stringstream errmsg;
+            errmsg << "Sort column index " << key << " is out of range";
+            throw py::value_error(errmsg.str());
+        }
+        if (!isComparableType(*type.getSubtype(key))) {
+            std::stringstream errmsg;
+            errmsg << "Cannot sort by column '" << type.getFieldName(key)
+                   << "' of type " << type.getSubtype(key)->toString();
+            throw py::value_error(errmsg.str());
+        }
+    }
+}
+
+template <typename T>
+static int
+compareValues(const T& left, const T& right)
+{
+    if (left < right) {
+        return -1;
+    }
+    return right < left ? 1 : 0;
+}
+
+static int
+compareDoubles(double left, double right)
+{
+    /* NaN is ordered after every other value. */
+    if (std::isnan(left) || std::isnan(right)) {
+        return static_cast<int>(std::isnan(left)) - static_cast<int>(std::isnan(right));
+    }
+    return compareValues(left, right);
+}
+
+static bool
+isDecimal64(const orc::Type& type)
+{
+    return type.getPrecision() != 0 && type.getPrecision() <= 18;
+}
+
+int
+compareRows(const orc::Type& type,
+            const orc::ColumnVectorBatch& left,
+            uint64_t leftRow,
+            const orc::ColumnVectorBatch& right,
+            uint64_t rightRow)
+{
+    bool leftNull = left.hasNulls && !left.notNull[leftRow];
+    bool rightNull = right.hasNulls && !right.notNull[rightRow];
+    if (leftNull || rightNull) {
+        return static_cast<int>(rightNull) - static_cast<int>(leftNull);
+    }
+    switch (static_cast<int64_t>(type.getKind())) {
+        case orc::FLOAT:
+        case orc::DOUBLE:
+            return compareDoubles(
+              static_cast<const orc::DoubleVectorBatch&>(left).data[leftRow],
+              static_cast<const orc::DoubleVectorBatch&>(right).data[rightRow]);
+        case orc::STRING:
+        case orc::VARCHAR:
+        case orc::CHAR:
+        case orc::BINARY: {
+            const auto& lhs = static_cast<const orc::StringVectorBatch&>(left);
+            const auto& rhs = static_cast<const orc::StringVectorBatch&>(right);
+            int64_t leftLen = lhs.length[leftRow];
+            int64_t rightLen = rhs.length[rightRow];
+            int res = std::memcmp(lhs.data[leftRow],
+                                  rhs.data[rightRow],
+                                  static_cast<size_t>(std::min(leftLen, rightLen)));
+            return res != 0 ? res : compareValues(leftLen, rightLen);
+        }
+        case orc::TIMESTAMP:
+        case orc::TIMESTAMP_INSTANT: {
+            const auto& lhs = static_cast<const orc::TimestampVectorBatch&>(left);
+            const auto& rhs = static_cast<const orc::TimestampVectorBatch&>(right);
+            int res = compareValues(lhs.data[leftRow], rhs.data[rightRow]);
+            return res != 0 ? res
+                            : compareValues(lhs.nanoseconds[leftRow],
+                                            rhs.nanoseconds[rightRow]);
+        }
+        case orc::DECIMAL:
+            if (isDecimal64(type)) {
+                const auto& lhs = static_cast<const orc::Decimal64VectorBatch&>(left);
+                const auto& rhs = static_cast<const orc::Decimal64VectorBatch&>(right);
+                return compareValues(lhs.values[leftRow], rhs.values[rightRow]);
+            } else {
+                const auto& lhs = static_cast<const orc::Decimal128VectorBatch&>(left);
+                const auto& rhs = static_cast<const orc::Decimal128VectorBatch&>(right);
+                return compareValues(lhs.values[leftRow], rhs.values[rightRow]);
+            }
+        case orc::BOOLEAN:
+        case orc::BYTE:
+        case orc::SHORT:
+        case orc::INT:
+        case orc::LONG:
+        case orc::DATE:
+            return compareValues(
+              static_cast<const orc::LongVectorBatch&>(left).data[leftRow],
+              static_cast<const orc::LongVectorBatch&>(right).data[rightRow]);
+        default: {
+            std::stringstream errmsg;
+            errmsg << "Values of type " << type.toString() << " cannot be compared";
+            throw py::value_error(errmsg.str());
+        }
+    }
+}
+
+void
+resetBatch(const orc::Type& type, orc::ColumnVectorBatch& batch)
+{
+    batch.numElements = 0;
+    batch.hasNulls = false;
+    switch (static_cast<int64_t>(type.getKind())) {
+        case orc::LIST: {
+            auto& listBatch = static_cast<orc::ListVectorBatch&>(batch);
+            listBatch.offsets[0] = 0;
+            resetBatch(*type.getSubtype(0), *listBatch.elements);
+            break;
+        }
+        case orc::MAP: {
+            auto& mapBatch = static_cast<orc::MapVectorBatch&>(batch);
+            mapBatch.offsets[0] = 0;
+            resetBatch(*type.getSubtype(0), *mapBatch.keys);
+            resetBatch(*type.getSubtype(1), *mapBatch.elements);
+            break;
+        }
+        case orc::STRUCT: {
+            auto& structBatch = static_cast<orc::StructVectorBatch&>(batch);
+            for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+                resetBatch(*type.getSubtype(i), *structBatch.fields[i]);
+            }
+            break;
+        }
+        case orc::UNION: {
+            auto& unionBatch = static_cast<orc::UnionVectorBatch&>(batch);
+            for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+                resetBatch(*type.getSubtype(i), *unionBatch.children[i]);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void
+reserve(orc::ColumnVectorBatch& batch, uint64_t size)
+{
+    if (batch.capacity < size) {
+        batch.resize(std::max(size, 2 * batch.capacity));
+    }
+}
+
+/* Appends the rows of [start, end) of the source to the destination. */
+static void
+copyRows(const orc::Type& type,
+         const orc::ColumnVectorBatch& src,
+         int64_t start,
+         int64_t end,
+         orc::ColumnVectorBatch& dst,
+         StringArena* arena)
+{
+    reserve(dst, dst.numElements + static_cast<uint64_t>(end - start));
+    for (int64_t i = start; i < end; ++i) {
+        copyRow(type, src, static_cast<uint64_t>(i), dst, arena);
+    }
+}
+
+void
+copyRow(const orc::Type& type,
+        const orc::ColumnVectorBatch& src,
+        uint64_t srcRow,
+        orc::ColumnVectorBatch& dst,
+        StringArena* arena)
+{
+    uint64_t dstRow = dst.numElements;
+    reserve(dst, dstRow + 1);
+    bool isNull = src.hasNulls && !src.notNull[srcRow];
+    dst.notNull[dstRow] = isNull ? 0 : 1;
+    dst.hasNulls = dst.hasNulls || isNull;
+    switch (static_cast<int64_t>(type.getKind())) {
+        case orc::FLOAT:
+        case orc::DOUBLE:
+            static_cast<orc::DoubleVectorBatch&>(dst).data[dstRow] =
+              static_cast<const orc::DoubleVectorBatch&>(src).data[srcRow];
+            break;
+        case orc::STRING:
+        case orc::VARCHAR:
+        case orc::CHAR:
+        case orc::BINARY: {
+            const auto& srcStr = static_cast<const orc::StringVectorBatch&>(src);
+            auto& dstStr = static_cast<orc::StringVectorBatch&>(dst);
+            int64_t length = srcStr.length[srcRow];
+            if (arena != nullptr && !isNull) {
+                dstStr.data[dstRow] =
+                  arena->copy(srcStr.data[srcRow], static_cast<size_t>(length));
+            } else {
+                dstStr.data[dstRow] = srcStr.data[srcRow];
+            }
+            dstStr.length[dstRow] = length;
+            break;
+        }
+        case orc::TIMESTAMP:
+        case orc::TIMESTAMP_INSTANT: {
+            const auto& srcTs = static_cast<const orc::TimestampVectorBatch&>(src);
+            auto& dstTs = static_cast<orc::TimestampVectorBatch&>(dst);
+            dstTs.data[dstRow] = srcTs.data[srcRow];
+            dstTs.nanoseconds[dstRow] = srcTs.nanoseconds[srcRow];
+            break;
+        }
+        case orc::DECIMAL:
+            if (isDecimal64(type)) {
+                const auto& srcDec = static_cast<const orc::Decimal64VectorBatch&>(src);
+                auto& dstDec = static_cast<orc::Decimal64VectorBatch&>(dst);
+                dstDec.precision = srcDec.precision;
+                dstDec.scale = srcDec.scale;
+                dstDec.values[dstRow] = srcDec.values[srcRow];
+            } else {
+                const auto& srcDec =
+                  static_cast<const orc::Decimal128VectorBatch&>(src);
+                auto& dstDec = static_cast<orc::Decimal128VectorBatch&>(dst);
+                dstDec.precision = srcDec.precision;
+                dstDec.scale = srcDec.scale;
+                dstDec.values[dstRow] = srcDec.values[srcRow];
+            }
+            break;
+        case orc::LIST: {
+            const auto& srcList = static_cast<const orc::ListVectorBatch&>(src);
+            auto& dstList = static_cast<orc::ListVectorBatch&>(dst);
+            if (dstRow == 0) {
+                dstList.offsets[0] = 0;
+            }
+            if (!isNull) {
+                copyRows(*type.getSubtype(0),
+                         *srcList.elements,
+                         srcList.offsets[srcRow],
+                         srcList.offsets[srcRow + 1],
+                         *dstList.elements,
+                         arena);
+            }
+            dstList.offsets[dstRow + 1] =
+              static_cast<int64_t>(dstList.elements->numElements);
+            break;
+        }
+        case orc::MAP: {
+            const auto& srcMap = static_cast<const orc::MapVectorBatch&>(src);
+            auto& dstMap = static_cast<orc::MapVectorBatch&>(dst);
+            if (dstRow == 0) {
+                dstMap.offsets[0] = 0;
+            }
+            if (!isNull) {
+                copyRows(*type.getSubtype(0),
+                         *srcMap.keys,
+                         srcMap.offsets[srcRow],
+                         srcMap.offsets[srcRow + 1],
+                         *dstMap.keys,
+                         arena);
+                copyRows(*type.getSubtype(1),
+                         *srcMap.elements,
+                         srcMap.offsets[srcRow],
+                         srcMap.offsets[srcRow + 1],
+                         *dstMap.elements,
+                         arena);
+            }
+            dstMap.offsets[dstRow + 1] = static_cast<int64_t>(dstMap.keys->numElements);
+            break;
+        }
+        case orc::STRUCT: {
+            /* The fields have a value for every row of the struct. */
+            const auto& srcStruct = static_cast<const orc::StructVectorBatch&>(src);
+            auto& dstStruct = static_cast<orc::StructVectorBatch&>(dst);
+            for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+                copyRow(*type.getSubtype(i),
+                        *srcStruct.fields[i],
+                        srcRow,
+                        *dstStruct.fields[i],
+                        arena);
+            }
+            break;
+        }
+        case orc::UNION: {
+            const auto& srcUnion = static_cast<const orc::UnionVectorBatch&>(src);
+            auto& dstUnion = static_cast<orc::UnionVectorBatch&>(dst);
+            if (!isNull) {
+                unsigned char tag = srcUnion.tags[srcRow];
+                orc::ColumnVectorBatch& child = *dstUnion.children[tag];
+                dstUnion.tags[dstRow] = tag;
+                dstUnion.offsets[dstRow] = child.numElements;
+                copyRow(*type.getSubtype(tag),
+                        *srcUnion.children[tag],
+                        srcUnion.offsets[srcRow],
+                        child,
+                        arena);
+            }
+            break;
+        }
+        default:
+            static_cast<orc::LongVectorBatch&>(dst).data[dstRow] =
+              static_cast<const orc::LongVectorBatch&>(src).data[srcRow];
+            break;
+    }
+    dst.numElements = dstRow + 1;
+}
+
+void
+copyStructRow(const orc::Type& type,
+              const orc::ColumnVectorBatch& src,
+              uint64_t srcRow,
+              const std::vector<uint64_t>& fields,
+              orc::ColumnVectorBatch& dst)
+{
+    const auto& srcStruct = static_cast<const orc::StructVectorBatch&>(src);
+    auto& dstStruct = static_cast<orc::StructVectorBatch&>(dst);
+    uint64_t dstRow = dst.numElements;
+    reserve(dst, dstRow + 1);
+    bool isNull = src.hasNulls && !src.notNull[srcRow];
+    dst.notNull[dstRow] = isNull ? 0 : 1;
+    dst.hasNulls = dst.hasNulls || isNull;
+    for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+        copyRow(*type.getSubtype(i),
+                *srcStruct.fields[fields[i]],
+                srcRow,
+                *dstStruct.fields[i]);
+    }
+    dst.numElements = dstRow + 1;
+}
@@ -0,0 +1,89 @@
+#ifndef VECTOR_BATCH_H
+#define VECTOR_BATCH_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "orc/OrcFile.hh"
+
+/* Stores copies of string and binary values, so the batches that point to
+   them do not depend on the lifetime of the source (Python objects or
+   another batch). The values are copied into fixed size chunks (a single
+   growing buffer, like the blob of StringVectorBatch, would invalidate the
+   already set data pointers when it reallocates). The chunks are kept and
+   reused after clear, only the blocks of the large values are freed. The
+   memory is allocated from the pool if it is given. */
+class StringArena
+{
+  private:
+    /* Leaves room for the header of a pool block in a power of two. */
+    static const size_t chunkSize = 262144 - 64;
+    struct BlockDeleter
+    {
+        orc::MemoryPool* pool;
+        void operator()(char*) const;
+    };
+    using Block = std::unique_ptr<char[], BlockDeleter>;
+    orc::MemoryPool* pool;
+    std::vector<Block> chunks;
+    std::vector<Block> largeBlocks;
+    size_t current = 0;
+    size_t used = 0;
+    Block allocate(size_t);
+
+  public:
+    StringArena(orc::MemoryPool* pool_ = nullptr)
+      : pool(pool_)
+    {}
+    char* copy(const char*, size_t);
+    void clear();
+};
+
+/* Native row operations on column vector batches, resolved by the ORC type
+   of the batch. None of them touch Python objects. */
+
+/* Whether the values of the type can be ordered by compareRows. */
+bool
+isComparableType(const orc::Type&);
+
+/* Checks that the indices of the top-level fields of a struct type can be
+   used to sort its rows. Raises ValueError otherwise. */
+void
+checkSortKeys(const orc::Type&, const std::vector<uint64_t>&);
+
+/* Compares two rows of batches with the same comparable type. Nulls are
+   ordered first. Returns a negative number, zero or a positive number. */
+int
+compareRows(const orc::Type&,
+            const orc::ColumnVectorBatch&,
+            uint64_t,
+            const orc::ColumnVectorBatch&,
+            uint64_t);
+
+/* Empties a batch and its children before filling it with copyRow. */
+void
+resetBatch(const orc::Type&, orc::ColumnVectorBatch&);
+
+/* Appends a row of a batch to another batch of the same type. The child
+   batches grow if necessary. String values are copied into the arena if it
+   is given, otherwise the destination points to the same memory as the
+   source. */
+void
+copyRow(const orc::Type&,
+        const orc::ColumnVectorBatch&,
+        uint64_t,
+        orc::ColumnVectorBatch&,
+        StringArena* = nullptr);
+
+/* Appends a row of a struct batch to a struct batch of the type, that has a
+   subset of the source's fields: the i-th field is copied from the
+   fields[i]-th field of the source. */
+void
+copyStructRow(const orc::Type&,
+              const orc::ColumnVectorBatch&,
+              uint64_t,
+              const std::vector<uint64_t>&,
+              orc::ColumnVectorBatch&);
+
+#endif
@@ -1,6 +1,23 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <type_traits>
+
 #include "Writer.h"
+#include "MemoryPool.h"
 #include "PyORCStream.h"
 
+static uint64_t
+elapsedNs(std::chrono::steady_clock::time_point start)
+{
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
 void
 setTypeAttributes(orc::Type* type, py::handle schema)
 {
@@ -99,11 +116,30 @@ Writer::Writer(py::object fileo,
                double padding_tolerance,
                double dict_key_size_threshold,
                py::object null_value,
-               unsigned int memory_block_size)
+               unsigned int memory_block_size,
+               py::object memory_pool,
+               bool collect_metrics,
+               uint64_t write_buffer_size,
+               bool async_flush,
+               std::vector<uint64_t> sort_by,
+               uint64_t sort_buffer_rows)
 {
     currentRow = 0;
     batchItem = 0;
-    ORC_UNIQUE_PTR<orc::Type> type = createType(schema);
+    type = createType(schema);
+    if (!sort_by.empty()) {
+        if (async_flush) {
+            throw py::value_error("Sorting rows is not supported with async_flush");
+        }
+        if (type->getKind() != orc::TypeKind::STRUCT) {
+            throw py::type_error("Sorting rows requires a struct schema");
+        }
+        if (sort_buffer_rows == 0) {
+            throw py::value_error("The sort buffer must hold at least one row");
+        }
+        checkSortKeys(*type, sort_by);
+        sortKeys = sort_by;
+    }
     orc::WriterOptions options;
     py::dict converters;
 
@@ -132,25 +168,164 @@ Writer::Writer(py::object fileo,
         std::string tzKey = py::cast<std::string>(tzone.attr("key"));
         options = options.setTimezoneName(tzKey);
     }
+    if (!memory_pool.is_none()) {
+        PyORCMemoryPool& pool = py::cast<PyORCMemoryPool&>(memory_pool);
+        options = options.setMemoryPool(&pool);
+        memoryPool = memory_pool;
+    }
 
-    outStream = std::unique_ptr<orc::OutputStream>(new PyORCOutputStream(fileo));
+    StreamMetrics* streamMetrics = nullptr;
+    if (collect_metrics) {
+        metrics = std::unique_ptr<WriteMetrics>(new WriteMetrics());
+        streamMetrics = &metrics->streamMetrics;
+        fileObject = fileo;
+    }
+    outStream = createOutputStream(fileo, write_buffer_size, streamMetrics);
     writer = orc::createWriter(*type, outStream.get(), options);
     batchSize = batch_size;
+    if (!sortKeys.empty()) {
+        sortedBatchSize = batch_size;
+        sortedBatch = writer->createRowBatch(sortedBatchSize);
+        batchSize = sort_buffer_rows;
+    }
     batch = writer->createRowBatch(batchSize);
-    converter = createConverter(type.get(), struct_repr, converters, tzone, null_value);
+    /* The string copies of the converters are allocated from the pool of the
+       writer, so they count against its limit. */
+    converter = createConverter(type.get(),
+                                struct_repr,
+                                converters,
+                                tzone,
+                                null_value,
+                                false,
+                                options.getMemoryPool());
+    if (async_flush) {
+        pendingBatch = writer->createRowBatch(batchSize);
+        pendingConverter = createConverter(type.get(),
+                                           struct_repr,
+                                           converters,
+                                           tzone,
+                                           null_value,
+                                           false,
+                                           options.getMemoryPool());
+        flushTask = std::unique_ptr<BackgroundTask>(new BackgroundTask());
+    }
+}
+
+Writer::~Writer()
+{
+    if (flushTask) {
+        /* The running task might need the GIL to write the output stream. */
+        py::gil_scoped_release gil;
+        flushTask.reset();
+    }
+}
+
+void
+Writer::waitForFlush()
+{
+    if (flushTask) {
+        py::gil_scoped_release gil;
+        flushTask->wait();
+    }
+}
+
+void
+Writer::addBatch()
+{
+    if (flushTask) {
+        /* Wait for the previous batch, then swap the buffers and add the
+           filled batch in the background while the other one is filled. */
+        waitForFlush();
+        pendingConverter->clear();
+        std::swap(batch, pendingBatch);
+        std::swap(converter, pendingConverter);
+        batchItem = 0;
+        orc::ColumnVectorBatch* filled = pendingBatch.get();
+        flushTask->submit([this, filled]() {
+            auto start = std::chrono::steady_clock::now();
+            writer->add(*filled);
+            if (metrics) {
+                metrics->addLatencyNs += elapsedNs(start);
+                ++metrics->addCall;
+            }
+        });
+        return;
+    }
+    if (!sortKeys.empty()) {
+        addSortedBatch();
+    } else {
+        auto start = std::chrono::steady_clock::now();
+        {
+            /* Encoding and compression do not touch Python objects. The output
+               stream acquires the GIL only when it calls the file-like object. */
+            py::gil_scoped_release gil;
+            writer->add(*batch);
+        }
+        if (metrics) {
+            metrics->addLatencyNs += elapsedNs(start);
+            ++metrics->addCall;
+        }
+    }
+    converter->clear();
+    batchItem = 0;
+}
+
+void
+Writer::addSortedBatch()
+{
+    const auto& structBatch = static_cast<const orc::StructVectorBatch&>(*batch);
+    std::vector<uint64_t> order(batchItem);
+    std::iota(order.begin(), order.end(), 0);
+    {
+        py::gil_scoped_release gil;
+        std::stable_sort(order.begin(), order.end(), [&](uint64_t lhs, uint64_t rhs) {
+            for (uint64_t key : sortKeys) {
+                int res = compareRows(*type->getSubtype(key),
+                                      *structBatch.fields[key],
+                                      lhs,
+                                      *structBatch.fields[key],
+                                      rhs);
+                if (res != 0) {
+                    return res < 0;
+                }
+            }
+            return false;
+        });
+    }
+    for (uint64_t start = 0; start < batchItem; start += sortedBatchSize) {
+        uint64_t end = std::min(start + sortedBatchSize, batchItem);
+        auto addStart = std::chrono::steady_clock::now();
+        {
+            py::gil_scoped_release gil;
+            resetBatch(*type, *sortedBatch);
+            for (uint64_t i = start; i < end; ++i) {
+                copyRow(*type, *batch, order[i], *sortedBatch);
+            }
+            writer->add(*sortedBatch);
+        }
+        if (metrics) {
+            metrics->addLatencyNs += elapsedNs(addStart);
+            ++metrics->addCall;
+        }
+    }
 }
 
 void
 Writer::write(py::object row)
 {
-    converter->write(batch.get(), batchItem, row);
+    if (metrics) {
+        auto start = std::chrono::steady_clock::now();
+        converter->write(batch.get(), batchItem, row);
+        metrics->conversionLatencyNs += elapsedNs(start);
+        ++metrics->conversionCall;
+    } else {
+        converter->write(batch.get(), batchItem, row);
+    }
     currentRow++;
     batchItem++;
 
     if (batchItem == batchSize) {
-        writer->add(*batch);
-        converter->clear();
-        batchItem = 0;
+        addBatch();
     }
 }
 
@@ -166,20 +341,608 @@ Writer::writerows(py::iterable iter)
     return rows;
 }
 
+/* The buffers of a single field for Writer::writeBatch: the values, the
+   UTF-8/binary data for string fields (where the values are the offsets)
+   and the optional validity mask. */
+struct ColumnBuffers
+{
+    py::buffer_info values;
+    py::buffer_info data;
+    py::buffer_info mask;
+    bool hasMask = false;
+    bool isBitmap = false;
+};
+
+static char
+bufferFormat(const py::buffer_info& info, const std::string& name)
+{
+    std::string format = info.format;
+    if (!format.empty() && (format[0] == '@' || format[0] == '=' || format[0] == '<')) {
+        format = format.substr(1);
+    }
+    if (info.ndim != 1 || format.size() != 1) {
+        std::stringstream errmsg;
+        errmsg << "Buffer of column '" << name << "' must be one-dimensional with "
+               << "a simple numeric format, not '" << info.format << "'";
+        throw py::type_error(errmsg.str());
+    }
+    return format[0];
+}
+
+static bool
+isIntegerFormat(char format)
+{
+    return format != 0 && std::strchr("bBhHiIlLqQ", format) != nullptr;
+}
+
+static bool
+isFloatFormat(char format)
+{
+    return format == 'f' || format == 'd';
+}
+
+template <typename S>
+static S
+readValue(const char* src)
+{
+    S value;
+    std::memcpy(&value, src, sizeof(S));
+    return value;
+}
+
+/* Any non-zero byte of a boolean buffer is true. */
+template <>
+bool
+readValue<bool>(const char* src)
+{
+    uint8_t value;
+    std::memcpy(&value, src, sizeof(value));
+    return value != 0;
+}
+
+template <typename S, typename D>
+static void
+castValues(const py::buffer_info& info, uint64_t start, uint64_t count, D* dest)
+{
+    const char* src = static_cast<const char*>(info.ptr) + start * info.strides[0];
+    if (std::is_same<S, D>::value && info.strides[0] == sizeof(D)) {
+        std::memcpy(dest, src, count * sizeof(D));
+        return;
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+        dest[i] = static_cast<D>(readValue<S>(src + i * info.strides[0]));
+    }
+}
+
+static void
+checkUnsignedRange(const py::buffer_info& info, const std::string& name)
+{
+    const char* src = static_cast<const char*>(info.ptr);
+    uint64_t size = static_cast<uint64_t>(info.shape[0]);
+    for (uint64_t i = 0; i < size; ++i) {
+        uint64_t value = readValue<uint64_t>(src + i * info.strides[0]);
+        if (value > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+            std::stringstream errmsg;
+            errmsg << "Value " << value << " of column '" << name
+                   << "' is out of range";
+            throw py::value_error(errmsg.str());
+        }
+    }
+}
+
+template <typename D>
+static void
+fillValues(const py::buffer_info& info,
+           const std::string& name,
+           uint64_t start,
+           uint64_t count,
+           D* dest)
+{
+    char format = bufferFormat(info, name);
+    bool isSigned = std::islower(format) != 0;
+    if (format == '?') {
+        castValues<bool, D>(info, start, count, dest);
+    } else if (isIntegerFormat(format) && info.itemsize == 1) {
+        isSigned ? castValues<int8_t, D>(info, start, count, dest)
+                 : castValues<uint8_t, D>(info, start, count, dest);
+    } else if (isIntegerFormat(format) && info.itemsize == 2) {
+        isSigned ? castValues<int16_t, D>(info, start, count, dest)
+                 : castValues<uint16_t, D>(info, start, count, dest);
+    } else if (isIntegerFormat(format) && info.itemsize == 4) {
+        isSigned ? castValues<int32_t, D>(info, start, count, dest)
+                 : castValues<uint32_t, D>(info, start, count, dest);
+    } else if (isIntegerFormat(format) && info.itemsize == 8) {
+        isSigned ? castValues<int64_t, D>(info, start, count, dest)
+                 : castValues<uint64_t, D>(info, start, count, dest);
+    } else if (format == 'f' && std::is_floating_point<D>::value) {
+        castValues<float, D>(info, start, count, dest);
+    } else if (format == 'd' && std::is_floating_point<D>::value) {
+        castValues<double, D>(info, start, count, dest);
+    } else {
+        std::stringstream errmsg;
+        errmsg << "Buffer of column '" << name << "' has an unsupported format '"
+               << info.format << "'";
+        throw py::type_error(errmsg.str());
+    }
+}
+
+static int64_t
+readOffset(const py::buffer_info& info, uint64_t idx)
+{
+    const char* src = static_cast<const char*>(info.ptr) + idx * info.strides[0];
+    if (info.itemsize == 4) {
+        int32_t value;
+        std::memcpy(&value, src, sizeof(value));
+        return value;
+    } else {
+        int64_t value;
+        std::memcpy(&value, src, sizeof(value));
+        return value;
+    }
+}
+
+static uint64_t
+checkStringBuffers(const ColumnBuffers& buffers, const std::string& name)
+{
+    char format = bufferFormat(buffers.values, name);
+    if (!(format == 'i' || format == 'l' || format == 'q') ||
+        (buffers.values.itemsize != 4 && buffers.values.itemsize != 8)) {
+        std::stringstream errmsg;
+        errmsg << "Offsets of column '" << name
+               << "' must be a buffer of 32 or 64 bit signed integers";
+        throw py::type_error(errmsg.str());
+    }
+    if (buffers.data.ndim != 1 || buffers.data.itemsize != 1 ||
+        buffers.data.strides[0] != 1) {
+        std::stringstream errmsg;
+        errmsg << "Data of column '" << name << "' must be a contiguous byte buffer";
+        throw py::type_error(errmsg.str());
+    }
+    uint64_t size = static_cast<uint64_t>(buffers.values.shape[0]);
+    if (size == 0) {
+        std::stringstream errmsg;
+        errmsg << "Offsets of column '" << name << "' must not be empty";
+        throw py::value_error(errmsg.str());
+    }
+    int64_t prev = readOffset(buffers.values, 0);
+    for (uint64_t i = 1; i < size; ++i) {
+        int64_t curr = readOffset(buffers.values, i);
+        if (prev < 0 || curr < prev || curr > buffers.data.shape[0]) {
+            std::stringstream errmsg;
+            errmsg << "Invalid offset " << curr << " at index " << i << " of column '"
+                   << name << "'";
+            throw py::value_error(errmsg.str());
+        }
+        prev = curr;
+    }
+    return size - 1;
+}
+
+static void
+fillStrings(const ColumnBuffers& buffers,
+            uint64_t start,
+            uint64_t count,
+            orc::StringVectorBatch* strBatch)
+{
+    char* data = static_cast<char*>(buffers.data.ptr);
+    int64_t begin = readOffset(buffers.values, start);
+    for (uint64_t i = 0; i < count; ++i) {
+        int64_t end = readOffset(buffers.values, start + i + 1);
+        strBatch->data[i] = data + begin;
+        strBatch->length[i] = end - begin;
+        begin = end;
+    }
+}
+
+static bool
+fillNotNull(const ColumnBuffers& buffers,
+            uint64_t start,
+            uint64_t count,
+            orc::ColumnVectorBatch* fieldBatch)
+{
+    char* notNull = fieldBatch->notNull.data();
+    if (!buffers.hasMask) {
+        std::memset(notNull, 1, count);
+        return false;
+    }
+    const char* mask = static_cast<const char*>(buffers.mask.ptr);
+    bool hasNulls = false;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t idx = start + i;
+        if (buffers.isBitmap) {
+            notNull[i] = (mask[idx / 8] >> (idx % 8)) & 1;
+        } else {
+            notNull[i] = mask[idx * buffers.mask.strides[0]] != 0;
+        }
+        hasNulls |= !notNull[i];
+    }
+    return hasNulls;
+}
+
+uint64_t
+Writer::writeBatch(py::dict columns, py::dict nullMasks)
+{
+    if (type->getKind() != orc::STRUCT) {
+        throw py::type_error("Columnar writing requires a struct type schema");
+    }
+    uint64_t numRows = 0;
+    std::vector<ColumnBuffers> fields(type->getSubtypeCount());
+    for (size_t i = 0; i < type->getSubtypeCount(); ++i) {
+        const std::string& name = type->getFieldName(i);
+        py::str key(name);
+        if (!columns.contains(key)) {
+            throw py::value_error("Missing column '" + name + "'");
+        }
+        py::object column = columns[key];
+        uint64_t size = 0;
+        int64_t kind = static_cast<int64_t>(type->getSubtype(i)->getKind());
+        switch (kind) {
+            case orc::BOOLEAN:
+            case orc::BYTE:
+            case orc::SHORT:
+            case orc::INT:
+            case orc::LONG:
+            case orc::DATE:
+            case orc::FLOAT:
+            case orc::DOUBLE: {
+                if (!py::isinstance<py::buffer>(column)) {
+                    throw py::type_error("Column '" + name +
+                                         "' must support the buffer protocol");
+                }
+                fields[i].values = py::reinterpret_borrow<py::buffer>(column).request();
+                char format = bufferFormat(fields[i].values, name);
+                bool isFloatKind = kind == orc::FLOAT || kind == orc::DOUBLE;
+                if (!isIntegerFormat(format) && format != '?' &&
+                    !(isFloatFormat(format) && isFloatKind)) {
+                    throw py::type_error("Buffer of column '" + name +
+                                         "' has an unsupported format '" +
+                                         fields[i].values.format + "'");
+                }
+                if (isIntegerFormat(format) && std::isupper(format) != 0 &&
+                    fields[i].values.itemsize == 8) {
+                    checkUnsignedRange(fields[i].values, name);
+                }
+                size = static_cast<uint64_t>(fields[i].values.shape[0]);
+                break;
+            }
+            case orc::STRING:
+            case orc::VARCHAR:
+            case orc::CHAR:
+            case orc::BINARY: {
+                if (!py::isinstance<py::sequence>(column) || py::len(column) != 2 ||
+                    !py::isinstance<py::buffer>(column[py::int_(0)]) ||
+                    !py::isinstance<py::buffer>(column[py::int_(1)])) {
+                    throw py::type_error("Column '" + name + "' must be a pair of " +
+                                         "offsets and data buffers");
+                }
+                py::buffer offsets = column[py::int_(0)];
+                py::buffer data = column[py::int_(1)];
+                fields[i].values = offsets.request();
+                fields[i].data = data.request();
+                size = checkStringBuffers(fields[i], name);
+                break;
+            }
+            default:
+                throw py::type_error("Column '" + name +
+                                     "' has a type that is not supported for "
+                                     "columnar writing");
+        }
+        if (i == 0) {
+            numRows = size;
+        } else if (size != numRows) {
+            std::stringstream errmsg;
+            errmsg << "Column '" << name << "' has " << size << " rows instead of "
+                   << numRows;
+            throw py::value_error(errmsg.str());
+        }
+        if (nullMasks.contains(key) && !nullMasks[key].is_none()) {
+            py::object mask = nullMasks[key];
+            if (!py::isinstance<py::buffer>(mask)) {
+                throw py::type_error("Null mask of column '" + name +
+                                     "' must support the buffer protocol");
+            }
+            fields[i].mask = py::reinterpret_borrow<py::buffer>(mask).request();
+            fields[i].hasMask = true;
+            char format = bufferFormat(fields[i].mask, name);
+            uint64_t maskSize = static_cast<uint64_t>(fields[i].mask.shape[0]);
+            if (fields[i].mask.itemsize != 1 ||
+                (format != '?' && !isIntegerFormat(format) && format != 'c')) {
+                throw py::type_error("Null mask of column '" + name +
+                                     "' must be a buffer of booleans or bytes");
+            }
+            if (maskSize == size) {
+                fields[i].isBitmap = false;
+            } else if (format != '?' && maskSize == (size + 7) / 8 &&
+                       fields[i].mask.strides[0] == 1) {
+                fields[i].isBitmap = true;
+            } else {
+                throw py::value_error("Null mask of column '" + name +
+                                      "' has an invalid length");
+            }
+        }
+    }
+    if (batchItem != 0) {
+        addBatch();
+    }
+    for (uint64_t start = 0; start < numRows; start += batchSize) {
+        uint64_t count = std::min(batchSize, numRows - start);
+        auto* structBatch = dynamic_cast<orc::StructVectorBatch*>(batch.get());
+        for (size_t i = 0; i < fields.size(); ++i) {
+            const std::string& name = type->getFieldName(i);
+            orc::ColumnVectorBatch* fieldBatch = structBatch->fields[i];
+            switch (static_cast<int64_t>(type->getSubtype(i)->getKind())) {
+                case orc::FLOAT:
+                case orc::DOUBLE: {
+                    auto* dblBatch = dynamic_cast<orc::DoubleVectorBatch*>(fieldBatch);
+                    fillValues(
+                      fields[i].values, name, start, count, dblBatch->data.data());
+                    break;
+                }
+                case orc::STRING:
+                case orc::VARCHAR:
+                case orc::CHAR:
+                case orc::BINARY:
+                    fillStrings(fields[i],
+                                start,
+                                count,
+                                dynamic_cast<orc::StringVectorBatch*>(fieldBatch));
+                    break;
+                default: {
+                    auto* longBatch = dynamic_cast<orc::LongVectorBatch*>(fieldBatch);
+                    fillValues(
+                      fields[i].values, name, start, count, longBatch->data.data());
+                    break;
+                }
+            }
+            fieldBatch->hasNulls = fillNotNull(fields[i], start, count, fieldBatch);
+            fieldBatch->numElements = count;
+        }
+        structBatch->hasNulls = false;
+        structBatch->numElements = count;
+        batchItem = count;
+        addBatch();
+        currentRow += count;
+    }
+    /* The string batches point into the buffers, that are released on
+       return. */
+    waitForFlush();
+    return numRows;
+}
+
+uint64_t
+Writer::addArrowArray(const ArrowImport& import, const ArrowArray& array)
+{
+    /* Check the values before the first batch is added, so an invalid array
+       is not written partially. */
+    import.validate(array);
+    if (batchItem != 0) {
+        addBatch();
+    }
+    uint64_t length = static_cast<uint64_t>(array.length);
+    for (uint64_t start = 0; start < length; start += batchSize) {
+        uint64_t count = std::min(batchSize, length - start);
+        import.fill(array, start, count, batch.get());
+        batchItem = count;
+        addBatch();
+        currentRow += count;
+    }
+    /* The batches might point into the buffers of the array. */
+    waitForFlush();
+    return length;
+}
+
+uint64_t
+Writer::writeArrow(py::object data)
+{
+    uint64_t rows = 0;
+    if (py::hasattr(data, "__arrow_c_array__")) {
+        py::tuple capsules = data.attr("__arrow_c_array__")();
+        auto* schema = static_cast<ArrowSchema*>(
+          PyCapsule_GetPointer(capsules[0].ptr(), "arrow_schema"));
+        if (schema == nullptr) {
+            throw py::error_already_set();
+        }
+        auto* array = static_cast<ArrowArray*>(
+          PyCapsule_GetPointer(capsules[1].ptr(), "arrow_array"));
+        if (array == nullptr) {
+            throw py::error_already_set();
+        }
+        ArrowImport import(*type, *schema);
+        rows = addArrowArray(import, *array);
+    } else if (py::hasattr(data, "__arrow_c_stream__")) {
+        py::object capsule = data.attr("__arrow_c_stream__")();
+        auto* stream = static_cast<ArrowArrayStream*>(
+          PyCapsule_GetPointer(capsule.ptr(), "arrow_array_stream"));
+        if (stream == nullptr) {
+            throw py::error_already_set();
+        }
+        auto streamError = [stream]() {
+            const char* msg = stream->get_last_error(stream);
+            return py::value_error(msg != nullptr ? msg : "Failed to read the stream");
+        };
+        ArrowSchema schema;
+        if (stream->get_schema(stream, &schema) != 0) {
+            throw streamError();
+        }
+        std::unique_ptr<ArrowSchema, void (*)(ArrowSchema*)> schemaGuard(
+          &schema, [](ArrowSchema* ptr) { ptr->release(ptr); });
+        ArrowImport import(*type, schema);
+        while (true) {
+            ArrowArray array;
+            if (stream->get_next(stream, &array) != 0) {
+                throw streamError();
+            }
+            if (array.release == nullptr) {
+                break;
+            }
+            std::unique_ptr<ArrowArray, void (*)(ArrowArray*)> arrayGuard(
+              &array, [](ArrowArray* ptr) { ptr->release(ptr); });
+            rows += addArrowArray(import, array);
+        }
+    } else {
+        std::stringstream errmsg;
+        errmsg << "Object of type `" << (std::string)py::str(data.get_type())
+               << "` does not implement the Arrow PyCapsule interface";
+        throw py::type_error(errmsg.str());
+    }
+    return rows;
+}
+
 void
 Writer::close()
 {
     if (batchItem != 0) {
-        writer->add(*batch);
-        converter->clear();
-        batchItem = 0;
+        addBatch();
+    }
+    waitForFlush();
+    auto start = std::chrono::steady_clock::now();
+    {
+        py::gil_scoped_release gil;
+        writer->close();
+    }
+    if (metrics) {
+        metrics->closeLatencyNs += elapsedNs(start);
+        readFooterMetrics();
+    }
+}
+
+void
+Writer::appendRow(const orc::ColumnVectorBatch& src, uint64_t row)
+{
+    if (batchItem == 0) {
+        resetBatch(*type, *batch);
+    }
+    copyRow(*type, src, row, *batch);
+    rowAppended();
+}
+
+void
+Writer::appendRow(const orc::ColumnVectorBatch& src,
+                  uint64_t row,
+                  const std::vector<uint64_t>& fields)
+{
+    if (batchItem == 0) {
+        resetBatch(*type, *batch);
+    }
+    copyStructRow(*type, src, row, fields, *batch);
+    rowAppended();
+}
+
+void
+Writer::rowAppended()
+{
+    currentRow++;
+    batchItem++;
+
+    if (batchItem == batchSize) {
+        addBatch();
+    }
+}
+
+void
+Writer::flushRows()
+{
+    if (batchItem != 0) {
+        addBatch();
+    }
+    waitForFlush();
+}
+
+void
+Writer::addNativeBatch(orc::ColumnVectorBatch& src)
+{
+    if (!sortKeys.empty()) {
+        throw py::value_error("Cannot add a batch directly with sorting rows");
+    }
+    flushRows();
+    auto start = std::chrono::steady_clock::now();
+    {
+        py::gil_scoped_release gil;
+        writer->add(src);
+    }
+    if (metrics) {
+        metrics->addLatencyNs += elapsedNs(start);
+        ++metrics->addCall;
+    }
+    currentRow += src.numElements;
+}
+
+const orc::Type&
+Writer::schemaType() const
+{
+    return *type;
+}
+
+uint64_t
+Writer::bytesWritten() const
+{
+    return outStream->getLength();
+}
+
+void
+Writer::readFooterMetrics()
+{
+    /* The stripe and stream information are only available from the file
+       footer, that can be read back from a path or if the file-like object
+       is readable. */
+    std::unique_ptr<orc::InputStream> inStream;
+    py::object position = py::none();
+    if (dynamic_cast<NativeOutputStream*>(outStream.get()) != nullptr) {
+        inStream = orc::readLocalFile(outStream->getName());
+    } else {
+        if (!py::hasattr(fileObject, "readable") ||
+            !py::hasattr(fileObject, "seekable") ||
+            !py::cast<bool>(fileObject.attr("readable")()) ||
+            !py::cast<bool>(fileObject.attr("seekable")())) {
+            return;
+        }
+        position = fileObject.attr("tell")();
+        inStream.reset(new PyORCInputStream(fileObject));
+    }
+    std::unique_ptr<orc::Reader> reader =
+      orc::createReader(std::move(inStream), orc::ReaderOptions());
+    metrics->stripes = reader->getNumberOfStripes();
+    for (uint64_t i = 0; i < metrics->stripes; ++i) {
+        std::unique_ptr<orc::StripeInformation> stripe = reader->getStripe(i);
+        for (uint64_t j = 0; j < stripe->getNumberOfStreams(); ++j) {
+            std::unique_ptr<orc::StreamInformation> stream =
+              stripe->getStreamInformation(j);
+            metrics->columnSizes[stream->getColumnId()] += stream->getLength();
+        }
+    }
+    metrics->hasFooter = true;
+    if (!position.is_none()) {
+        fileObject.attr("seek")(position);
+    }
+}
+
+py::object
+Writer::writerMetrics()
+{
+    if (!metrics) {
+        return py::none();
+    }
+    waitForFlush();
+    py::dict res;
+    res["conversion_call"] = metrics->conversionCall;
+    res["conversion_latency_us"] = metrics->conversionLatencyNs / 1000;
+    res["add_call"] = metrics->addCall;
+    res["add_latency_us"] = metrics->addLatencyNs / 1000;
+    res["close_latency_us"] = metrics->closeLatencyNs / 1000;
+    res["io_call"] = metrics->streamMetrics.writeCall;
+    res["io_latency_us"] = metrics->streamMetrics.writeLatencyNs / 1000;
+    res["bytes_written"] = outStream->getLength();
+    if (metrics->hasFooter) {
+        res["stripes"] = metrics->stripes;
+        res["column_sizes"] = py::cast(metrics->columnSizes);
     }
-    writer->close();
+    return res;
 }
 
 void
 Writer::addUserMetadata(py::str key, py::bytes value)
 {
+    waitForFlush();
     writer->addUserMetadata(key, value);
 }
 
@@ -187,6 +950,8 @@ Writer::addUserMetadata(py::str key, py::bytes value)
 uint64_t
 Writer::writeIntermediateFooter()
 {
+    waitForFlush();
+    py::gil_scoped_release gil;
     return writer->writeIntermediateFooter();
 }
 #endif
@@ -6,20 +6,57 @@
 
 #include "orc/OrcFile.hh"
 
+#include "ArrowImport.h"
+#include "BackgroundTask.h"
 #include "Converter.h"
+#include "PyORCStream.h"
+#include "VectorBatch.h"
 #include "verguard.h"
 
 namespace py = pybind11;
 
+struct WriteMetrics
+{
+    StreamMetrics streamMetrics;
+    uint64_t conversionCall = 0;
+    uint64_t conversionLatencyNs = 0;
+    uint64_t addCall = 0;
+    uint64_t addLatencyNs = 0;
+    uint64_t closeLatencyNs = 0;
+    bool hasFooter = false;
+    uint64_t stripes = 0;
+    std::map<uint64_t, uint64_t> columnSizes;
+};
+
 class Writer
 {
   private:
+    py::object memoryPool;
+    py::object fileObject;
+    std::unique_ptr<WriteMetrics> metrics;
+    std::unique_ptr<orc::Type> type;
     std::unique_ptr<orc::OutputStream> outStream;
     std::unique_ptr<orc::Writer> writer;
     std::unique_ptr<orc::ColumnVectorBatch> batch;
     std::unique_ptr<Converter> converter;
+    /* The batch and converter that are added by the background task, while
+       the other pair is filled. Only used with async flushing. */
+    std::unique_ptr<orc::ColumnVectorBatch> pendingBatch;
+    std::unique_ptr<Converter> pendingConverter;
+    std::unique_ptr<BackgroundTask> flushTask;
+    /* The fields to sort the rows by. The batch buffers the rows to sort and
+       the sorted rows are copied into the sorted batch for encoding. */
+    std::vector<uint64_t> sortKeys;
+    std::unique_ptr<orc::ColumnVectorBatch> sortedBatch;
+    uint64_t sortedBatchSize;
     uint64_t batchSize;
     uint64_t batchItem;
+    void addBatch();
+    void addSortedBatch();
+    void rowAppended();
+    void waitForFlush();
+    uint64_t addArrowArray(const ArrowImport&, const ArrowArray&);
+    void readFooterMetrics();
 
   public:
     uint64_t currentRow;
@@ -40,15 +77,36 @@ class Writer
            double = 0.0,
            double = 0.0,
            py::object = py::none(),
-           unsigned int = 65536);
+           unsigned int = 65536,
+           py::object = py::none(),
+           bool = false,
+           uint64_t = 8388608,
+           bool = false,
+           std::vector<uint64_t> = {},
+           uint64_t = 262144);
     void addUserMetadata(py::str, py::bytes);
     void write(py::object);
     uint64_t writerows(py::iterable);
+    uint64_t writeBatch(py::dict, py::dict);
+    uint64_t writeArrow(py::object);
 #if ORC_VERSION_AT_LEAST(1, 9, 0)
     uint64_t writeIntermediateFooter();
 #endif
     void close();
-    ~Writer(){};
+    /* Appends a row of a batch with the same type without conversion. The
+       batch must be kept until the rows are flushed. */
+    void appendRow(const orc::ColumnVectorBatch&, uint64_t);
+    /* Appends the given top-level fields of a struct batch's row. */
+    void appendRow(const orc::ColumnVectorBatch&,
+                   uint64_t,
+                   const std::vector<uint64_t>&);
+    void flushRows();
+    /* Adds a batch with the same type to the ORC writer as it is. */
+    void addNativeBatch(orc::ColumnVectorBatch&);
+    const orc::Type& schemaType() const;
+    uint64_t bytesWritten() const;
+    py::object writerMetrics();
+    ~Writer();
 };
 
 #endif
@@ -1,4 +1,8 @@
+#include "Compaction.h"
+#include "MemoryPool.h"
+#include "PartitionedWriter.h"
 #include "Reader.h"
+#include "Sort.h"
 #include "Writer.h"
 #include "verguard.h"
 
@@ -18,6 +22,27 @@ PYBIND11_MODULE(_pyorc, m)
             throw py::value_error(err.what());
         }
     });
+    m.def("_concat_files",
+          &concatFiles,
+          py::arg("inputs"),
+          py::arg("output"),
+          py::arg_v("batch_size", 1024, "1024"));
+    m.def("_rewrite_file",
+          &rewriteFile,
+          py::arg("input"),
+          py::arg("output"),
+          py::arg("columns"),
+          py::arg("predicate"),
+          py::arg("timezone"),
+          py::arg_v("batch_size", 1024, "1024"));
+    m.def("_sort_files",
+          &sortFiles,
+          py::arg("inputs"),
+          py::arg("output"),
+          py::arg("keys"),
+          py::arg("memory_limit"),
+          py::arg("tmp_prefix"),
+          py::arg_v("batch_size", 1024, "1024"));
     py::register_exception_translator([](std::exception_ptr p) {
         try {
             if (p) {
@@ -28,6 +53,18 @@ PYBIND11_MODULE(_pyorc, m)
             PyErr_SetString(err.ptr(), e.what());
         }
     });
+    py::class_<PyORCMemoryPool>(m, "memory_pool")
+      .def(py::init<uint64_t, uint64_t>(),
+           py::arg_v("limit", 0, "0"),
+           py::arg_v("max_cached", 67108864, "67108864"))
+      .def("release", &PyORCMemoryPool::release)
+      .def("reset_peak", &PyORCMemoryPool::resetPeak)
+      .def_property(
+        "limit", &PyORCMemoryPool::getLimit, &PyORCMemoryPool::setLimit)
+      .def_property_readonly("live_bytes", &PyORCMemoryPool::getLiveBytes)
+      .def_property_readonly("peak_bytes", &PyORCMemoryPool::getPeakBytes)
+      .def_property_readonly("cached_bytes", &PyORCMemoryPool::getCachedBytes)
+      .def_property_readonly("allocations", &PyORCMemoryPool::getAllocations);
     py::class_<Stripe>(m, "stripe")
       .def(
         py::init([](Reader& reader, uint64_t num) { return reader.readStripe(num); }),
@@ -55,7 +92,12 @@ PYBIND11_MODULE(_pyorc, m)
                     unsigned int,
                     py::object,
                     py::object,
-                    py::object>(),
+                    py::object,
+                    py::object,
+                    bool,
+                    bool,
+                    bool,
+                    bool>(),
            py::arg("fileo"),
            py::arg_v("batch_size", 1024, "1024"),
            py::arg_v("col_indices", std::list<uint64_t>{}, "None"),
@@ -64,13 +106,28 @@ PYBIND11_MODULE(_pyorc, m)
            py::arg_v("struct_repr", 0, "StructRepr.TUPLE"),
            py::arg_v("conv", py::none(), "None"),
            py::arg_v("predicate", py::none(), "None"),
-           py::arg_v("null_value", py::none(), "None"))
+           py::arg_v("null_value", py::none(), "None"),
+           py::arg_v("memory_pool", py::none(), "None"),
+           py::arg_v("collect_metrics", false, "False"),
+           py::arg_v("metadata_only", false, "False"),
+           py::arg_v("tight_numeric_vector", false, "False"),
+           py::arg_v("numeric_arrays", false, "False"))
       .def("__next__", [](Reader& r) -> py::object { return r.next(); })
       .def("__iter__", [](Reader& r) -> Reader& { return r; })
       .def("__len__", &Reader::len)
       .def("read", &Reader::read, py::arg_v("num", -1, "-1"))
+      .def("_next_batch", &Reader::nextBatch)
       .def("seek", &Reader::seek, py::arg("row"), py::arg_v("whence", 0, "0"))
+      .def("take", &Reader::take, py::arg("row_numbers"))
+      .def("seek_key", &Reader::seekKey, py::arg("column"), py::arg("value"))
       .def("_statistics", &Reader::statistics)
+      .def("stripe_statistics", &Reader::stripeStatistics, py::arg("columns"))
+      .def("reduce",
+           &Reader::reduce,
+           py::arg("column"),
+           py::arg("kind"),
+           py::arg_v("bins", 10, "10"))
+      .def_property_readonly("metrics", &Reader::readerMetrics)
       .def_property_readonly("bytes_lengths", &Reader::bytesLengths)
       .def_property_readonly("compression", &Reader::compression)
       .def_property_readonly("compression_block_size", &Reader::compressionBlockSize)
@@ -102,7 +159,13 @@ PYBIND11_MODULE(_pyorc, m)
                     double,
                     double,
                     py::object,
-                    unsigned int>(),
+                    unsigned int,
+                    py::object,
+                    bool,
+                    uint64_t,
+                    bool,
+                    std::vector<uint64_t>,
+                    uint64_t>(),
            py::arg("fileo"),
            py::arg("schema"),
            py::arg_v("batch_size", 1024, "1024"),
@@ -119,13 +182,45 @@ PYBIND11_MODULE(_pyorc, m)
            py::arg_v("padding_tolerance", 0.0, "0.0"),
            py::arg_v("dict_key_size_threshold", 0.0, "0.0"),
            py::arg_v("null_value", py::none(), "None"),
-           py::arg_v("memory_block_size", 65536, "65536"))
+           py::arg_v("memory_block_size", 65536, "65536"),
+           py::arg_v("memory_pool", py::none(), "None"),
+           py::arg_v("collect_metrics", false, "False"),
+           py::arg_v("write_buffer_size", 8388608, "8388608"),
+           py::arg_v("async_flush", false, "False"),
+           py::arg_v("sort_by", std::vector<uint64_t>{}, "None"),
+           py::arg_v("sort_buffer_rows", 262144, "262144"))
       .def("_add_user_metadata", &Writer::addUserMetadata)
       .def("write", &Writer::write)
       .def("writerows", &Writer::writerows)
+      .def("write_batch",
+           &Writer::writeBatch,
+           py::arg("columns"),
+           py::arg("null_masks"))
+      .def("write_arrow", &Writer::writeArrow, py::arg("data"))
 #if ORC_VERSION_AT_LEAST(1, 9, 0)
       .def("write_intermediate_footer", &Writer::writeIntermediateFooter)
 #endif
       .def("close", &Writer::close)
+      .def_property_readonly("metrics", &Writer::writerMetrics)
       .def_readonly("current_row", &Writer::currentRow);
+    py::class_<PartitionedWriter>(m, "partitioned_writer")
+      .def(py::init<py::object,
+                    py::list,
+                    py::object,
+                    uint64_t,
+                    uint64_t,
+                    uint64_t,
+                    uint64_t>(),
+           py::arg("open_writer"),
+           py::arg("key_fields"),
+           py::arg_v("memory_pool", py::none(), "None"),
+           py::arg_v("max_open_files", 0, "0"),
+           py::arg_v("memory_limit", 0, "0"),
+           py::arg_v("max_rows", 0, "0"),
+           py::arg_v("max_bytes", 0, "0"))
+      .def("write", &PartitionedWriter::write)
+      .def("writerows", &PartitionedWriter::writerows)
+      .def("close", &PartitionedWriter::close)
+      .def_property_readonly("open_partitions", &PartitionedWriter::openPartitions)
+      .def_readonly("current_row", &PartitionedWriter::currentRow);
 }
@@ -12,12 +12,15 @@ if sys.platform.startswith("win32") and "TZDIR" not in os.environ:
 
 from pyorc._pyorc import _orc_version
 
+from .compaction import concat, rewrite
 from .enums import *
 from .errors import *
+from .memory import MemoryPool
 from .predicates import PredicateColumn
 from .reader import Column, Reader, Stripe
+from .sort import sort_files
 from .typedescription import *
-from .writer import Writer
+from .writer import PartitionedWriter, Writer
 
 __version__ = "0.11.0"
 
@@ -41,15 +44,21 @@ orc_version_info = __extract_version_info()
 
 __all__ = [
     "Column",
+    "MemoryPool",
+    "PartitionedWriter",
     "PredicateColumn",
     "Reader",
     "Stripe",
     "Writer",
+    "concat",
+    "rewrite",
+    "sort_files",
     # Enums
     "CompressionKind",
     "CompressionStrategy",
     "TypeKind",
     "StructRepr",
+    "ReduceKind",
     "WriterVersion",
     # Errors
     "ORCError",
@@ -4,7 +4,40 @@ import typing
 from .enums import CompressionKind, CompressionStrategy, StructRepr
 from .typedescription import TypeDescription
 
-__all__ = ["reader", "stripe", "writer"]
+__all__ = ["memory_pool", "reader", "stripe", "writer"]
+
+class memory_pool:
+    def __init__(self, limit: int = 0, max_cached: int = 67108864) -> None: ...
+    def release(self) -> None: ...
+    def reset_peak(self) -> None: ...
+    @property
+    def allocations(self) -> int:
+        """
+        :type: int
+        """
+    @property
+    def cached_bytes(self) -> int:
+        """
+        :type: int
+        """
+    @property
+    def limit(self) -> int:
+        """
+        :type: int
+        """
+    @limit.setter
+    def limit(self, val: int) -> None: ...
+    @property
+    def live_bytes(self) -> int:
+        """
+        :type: int
+        """
+    @property
+    def peak_bytes(self) -> int:
+        """
+        :type: int
+        """
+    pass
 
 class reader:
     def __init__(
@@ -18,13 +51,23 @@ class reader:
         conv: object = None,
         predicate: object = None,
         null_value: object = None,
+        memory_pool: typing.Optional[memory_pool] = None,
+        collect_metrics: bool = False,
+        metadata_only: bool = False,
+        tight_numeric_vector: bool = False,
+        numeric_arrays: bool = False,
     ) -> None: ...
     def __iter__(self) -> reader: ...
     def __len__(self) -> int: ...
     def __next__(self) -> object: ...
+    def _next_batch(self) -> object: ...
     def _statistics(self, col_idx: int) -> tuple: ...
-    def read(self, num: int = -1) -> list: ...
+    def read(self, num: int = -1) -> object: ...
+    def reduce(self, column: int, kind: int, bins: int = 10) -> dict: ...
     def seek(self, row: int, whence: int = 0) -> int: ...
+    def seek_key(self, column: int, value: object) -> int: ...
+    def stripe_statistics(self, columns: typing.List[int]) -> list: ...
+    def take(self, row_numbers: typing.List[int]) -> list: ...
     @property
     def bytes_lengths(self) -> typing.Dict[str, int]:
         """
@@ -51,6 +94,11 @@ class reader:
         :type: tuple
         """
     @property
+    def metrics(self) -> typing.Optional[typing.Dict[str, int]]:
+        """
+        :type: dict
+        """
+    @property
     def num_of_stripes(self) -> int:
         """
         :type: int
@@ -151,16 +199,56 @@ class writer:
         padding_tolerance: float = 0.0,
         dict_key_size_threshold: float = 0.0,
         null_value: object = None,
+        memory_block_size: int = 65536,
+        memory_pool: typing.Optional[memory_pool] = None,
+        collect_metrics: bool = False,
+        write_buffer_size: int = 8388608,
+        async_flush: bool = False,
+        sort_by: typing.Optional[typing.List[int]] = None,
+        sort_buffer_rows: int = 262144,
     ) -> None: ...
     def _add_user_metadata(self, key: str, value: bytes) -> None: ...
     def close(self) -> None: ...
     def write(self, row: object) -> None: ...
     def writerows(self, rows: typing.Iterable) -> int: ...
+    def write_arrow(self, data: object) -> int: ...
+    def write_batch(self, columns: dict, null_masks: dict) -> int: ...
     @property
     def current_row(self) -> int:
         """
         :type: int
         """
+    @property
+    def metrics(self) -> typing.Optional[typing.Dict[str, object]]:
+        """
+        :type: dict
+        """
+    pass
+
+class partitioned_writer:
+    def __init__(
+        self,
+        open_writer: typing.Callable[[tuple, int], writer],
+        key_fields: list,
+        memory_pool: typing.Optional[memory_pool] = None,
+        max_open_files: int = 0,
+        memory_limit: int = 0,
+        max_rows: int = 0,
+        max_bytes: int = 0,
+    ) -> None: ...
+    def close(self) -> None: ...
+    def write(self, row: object) -> None: ...
+    def writerows(self, rows: typing.Iterable) -> int: ...
+    @property
+    def current_row(self) -> int:
+        """
+        :type: int
+        """
+    @property
+    def open_partitions(self) -> int:
+        """
+        :type: int
+        """
     pass
 
 def _orc_version() -> str:
@@ -168,3 +256,28 @@ def _orc_version() -> str:
 
 def _schema_from_string(arg0: str) -> TypeDescription:
     pass
+
+def _concat_files(
+    inputs: typing.List[typing.BinaryIO], output: writer, batch_size: int = 1024
+) -> int:
+    pass
+
+def _rewrite_file(
+    input: typing.BinaryIO,
+    output: writer,
+    columns: typing.List[int],
+    predicate: typing.Any,
+    timezone: typing.Any,
+    batch_size: int = 1024,
+) -> int:
+    pass
+
+def _sort_files(
+    inputs: typing.List[typing.BinaryIO],
+    output: writer,
+    keys: typing.List[int],
+    memory_limit: int,
+    tmp_prefix: str,
+    batch_size: int = 1024,
+) -> int:
+    pass
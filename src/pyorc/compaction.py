@@ -0,0 +1,97 @@
+import contextlib
+import os
+from typing import Any, BinaryIO, Dict, List, Optional, Sequence, Union
+
+from pyorc._pyorc import _concat_files, _rewrite_file
+
+from .enums import TypeKind
+from .predicates import Predicate
+from .reader import Reader
+from .writer import Writer
+
+try:
+    import zoneinfo
+except ImportError:
+    from backports import zoneinfo
+
+
+def _open_inputs(
+    stack: contextlib.ExitStack, inputs: Sequence[Union[BinaryIO, str, os.PathLike]]
+) -> List[BinaryIO]:
+    return [
+        (
+            stack.enter_context(open(inp, "rb"))
+            if isinstance(inp, (str, bytes, os.PathLike))
+            else inp
+        )
+        for inp in inputs
+    ]
+
+
+def _layout_options(reader: Reader, writer_options: Dict[str, Any]) -> Dict[str, Any]:
+    # Keep the layout of the input, unless it's set explicitly.
+    options = {
+        "compression": reader.compression,
+        "compression_block_size": reader.compression_block_size,
+        "row_index_stride": reader.row_index_stride,
+    }
+    options.update(writer_options)
+    return options
+
+
+def concat(
+    inputs: Sequence[Union[BinaryIO, str, os.PathLike]],
+    output: Union[BinaryIO, str, os.PathLike],
+    batch_size: int = 1024,
+    **writer_options: Any,
+) -> int:
+    if not inputs:
+        raise ValueError("At least one input file is required")
+    if writer_options.get("sort_by"):
+        raise ValueError("concat does not support sort_by")
+    with contextlib.ExitStack() as stack:
+        files = _open_inputs(stack, inputs)
+        first = Reader(files[0], metadata_only=True)
+        options = _layout_options(first, writer_options)
+        writer = stack.enter_context(
+            Writer(output, first.schema, batch_size=batch_size, **options)
+        )
+        return _concat_files(files, writer, batch_size)
+
+
+def rewrite(
+    src: Union[BinaryIO, str, os.PathLike],
+    dst: Union[BinaryIO, str, os.PathLike],
+    columns: Optional[Sequence[str]] = None,
+    predicate: Optional[Predicate] = None,
+    batch_size: int = 1024,
+    **writer_options: Any,
+) -> int:
+    if writer_options.get("sort_by"):
+        raise ValueError("rewrite does not support sort_by")
+    with contextlib.ExitStack() as stack:
+        fileo = _open_inputs(stack, [src])[0]
+        reader = Reader(fileo, metadata_only=True)
+        schema = reader.schema
+        if schema.kind != TypeKind.STRUCT:
+            raise TypeError("Rewriting requires a struct schema")
+        field_names = list(schema.fields)
+        indices: List[int] = []
+        if columns is not None:
+            if isinstance(columns, str):
+                columns = [columns]
+            if not columns:
+                raise ValueError("At least one column must be selected")
+            for name in columns:
+                if name not in field_names:
+                    raise ValueError("Column '{0}' is not in the schema".format(name))
+            indices = sorted({field_names.index(name) for name in columns})
+            schema = Reader(
+                fileo, column_indices=indices, metadata_only=True
+            ).selected_schema
+        options = _layout_options(reader, writer_options)
+        timezone = options.get("timezone", zoneinfo.ZoneInfo("UTC"))
+        writer = stack.enter_context(
+            Writer(dst, schema, batch_size=batch_size, **options)
+        )
+        return _rewrite_file(fileo, writer, indices, predicate, timezone, batch_size)
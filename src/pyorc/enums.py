@@ -52,6 +52,16 @@ class StructRepr(enum.IntEnum):
 
     TUPLE = 0  #: For tuple.
     DICT = 1  #: For dictionary.
+    COLUMNS = 2  #: For dictionary of lists of column values (only for reading).
+
+
+class ReduceKind(enum.IntEnum):
+    """ Aggregation kinds for :meth:`Reader.reduce`. """
+
+    COUNT = 0  #: Number of non-null values.
+    SUM = 1  #: Sum of the values.
+    HISTOGRAM = 2  #: Equal-width histogram between the minimum and maximum.
+    DISTINCT = 3  #: Approximate number of distinct values.
 
 
 class WriterVersion(enum.IntEnum):
@@ -0,0 +1,22 @@
+from typing import Optional
+
+from pyorc._pyorc import memory_pool
+
+
+class MemoryPool(memory_pool):
+    def __init__(
+        self, limit: Optional[int] = None, max_cached: int = 67108864
+    ) -> None:
+        if limit is not None and limit <= 0:
+            raise ValueError("The memory limit must be positive")
+        super().__init__(limit or 0, max_cached)
+
+    @property
+    def limit(self) -> Optional[int]:
+        return super().limit or None
+
+    @limit.setter
+    def limit(self, val: Optional[int]) -> None:
+        if val is not None and val <= 0:
+            raise ValueError("The memory limit must be positive")
+        memory_pool.limit.fset(self, val or 0)
@@ -1,10 +1,11 @@
 from collections import defaultdict
-from typing import Any, BinaryIO, Dict, Iterator, List, Optional, Type, Union
+from typing import Any, BinaryIO, Dict, Iterable, Iterator, List, Optional, Type, Union
 
 from pyorc._pyorc import reader, stripe
 
 from .converters import DEFAULT_CONVERTERS, ORCConverter
-from .enums import CompressionKind, StructRepr, TypeKind, WriterVersion
+from .enums import CompressionKind, ReduceKind, StructRepr, TypeKind, WriterVersion
+from .memory import MemoryPool
 from .predicates import Predicate
 
 try:
@@ -62,6 +63,11 @@ class Reader(reader):
         converters: Optional[Dict[TypeKind, Type[ORCConverter]]] = None,
         predicate: Optional[Predicate] = None,
         null_value: Any = None,
+        memory_pool: Optional[MemoryPool] = None,
+        collect_metrics: bool = False,
+        metadata_only: bool = False,
+        tight_numeric_vector: bool = False,
+        numeric_arrays: bool = False,
     ) -> None:
         if column_indices is None:
             column_indices = []
@@ -84,11 +90,23 @@ class Reader(reader):
             conv,
             predicate,
             null_value,
+            memory_pool,
+            collect_metrics,
+            metadata_only,
+            tight_numeric_vector,
+            numeric_arrays,
         )
 
     def __getitem__(self, col_idx: int) -> Column:
         return Column(self, col_idx)
 
+    def iter_batches(self) -> Iterator[Union[List[Any], Dict[str, List[Any]]]]:
+        while True:
+            try:
+                yield self._next_batch()
+            except StopIteration:
+                return
+
     def read_stripe(self, stripe_idx: int) -> Stripe:
         return Stripe(self, stripe_idx)
 
@@ -96,6 +114,37 @@ class Reader(reader):
         for num in range(self.num_of_stripes):
             yield self.read_stripe(num)
 
+    def reduce(
+        self, column: Union[int, str], kind: ReduceKind, bins: int = 10
+    ) -> Dict[str, Any]:
+        if isinstance(column, str):
+            column = self.schema.find_column_id(column)
+        return super().reduce(column, ReduceKind(kind), bins)
+
+    def seek_key(self, column: Union[int, str], value: Any) -> int:
+        if isinstance(column, str):
+            column = self.schema.find_column_id(column)
+        return super().seek_key(column, value)
+
+    def stripe_statistics(
+        self, columns: Union[int, str, Iterable[Union[int, str]]]
+    ) -> Dict[Union[int, str], Dict[str, Any]]:
+        if isinstance(columns, (int, str)):
+            columns = [columns]
+        keys = list(columns)
+        indices = [
+            self.schema.find_column_id(col) if isinstance(col, str) else col
+            for col in keys
+        ]
+        result = {}
+        for col, stats in zip(keys, super().stripe_statistics(indices)):
+            stats["kind"] = TypeKind(stats["kind"])
+            result[col] = stats
+        return result
+
+    def take(self, row_numbers: Iterable[int]) -> List[Any]:
+        return super().take(list(row_numbers))
+
     @property
     def compression(self) -> CompressionKind:
         return CompressionKind(super().compression)
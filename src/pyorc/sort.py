@@ -0,0 +1,53 @@
+import contextlib
+import os
+import tempfile
+from typing import Any, BinaryIO, Optional, Sequence, Union
+
+from pyorc._pyorc import _sort_files
+
+from .compaction import _open_inputs
+from .enums import TypeKind
+from .reader import Reader
+from .writer import Writer
+
+
+def sort_files(
+    inputs: Sequence[Union[BinaryIO, str, os.PathLike]],
+    output: Union[BinaryIO, str, os.PathLike],
+    keys: Union[str, Sequence[str]],
+    memory_limit: int = 268435456,
+    batch_size: int = 1024,
+    tmp_dir: Optional[str] = None,
+    **writer_options: Any,
+) -> int:
+    if isinstance(keys, str):
+        keys = [keys]
+    if not inputs:
+        raise ValueError("At least one input file is required")
+    if not keys:
+        raise ValueError("At least one sort key is required")
+    if memory_limit <= 0:
+        raise ValueError("The `memory_limit` must be positive")
+    if writer_options.get("sort_by"):
+        raise ValueError("sort_files does not support sort_by")
+    with contextlib.ExitStack() as stack:
+        files = _open_inputs(stack, inputs)
+        schema = Reader(files[0], metadata_only=True).schema
+        if schema.kind != TypeKind.STRUCT:
+            raise TypeError("Sorting rows requires a struct schema")
+        field_names = list(schema.fields)
+        for name in keys:
+            if name not in field_names:
+                raise ValueError("Sort field '{0}' is not in the schema".format(name))
+        tmp = stack.enter_context(tempfile.TemporaryDirectory(dir=tmp_dir))
+        writer = stack.enter_context(
+            Writer(output, schema, batch_size=batch_size, **writer_options)
+        )
+        return _sort_files(
+            files,
+            writer,
+            [field_names.index(name) for name in keys],
+            memory_limit,
+            os.path.join(tmp, "run-"),
+            batch_size,
+        )
@@ -1,10 +1,24 @@
 import copy
-from typing import Any, BinaryIO, Dict, List, Optional, Type, Union
+import os
+from typing import (
+    Any,
+    BinaryIO,
+    Callable,
+    Dict,
+    List,
+    Mapping,
+    Optional,
+    Sequence,
+    Tuple,
+    Type,
+    Union,
+)
 
-from pyorc._pyorc import writer
+from pyorc._pyorc import partitioned_writer, writer
 
 from .converters import DEFAULT_CONVERTERS, ORCConverter
 from .enums import CompressionKind, CompressionStrategy, StructRepr, TypeKind
+from .memory import MemoryPool
 from .typedescription import TypeDescription
 
 try:
@@ -16,7 +30,7 @@ except ImportError:
 class Writer(writer):
     def __init__(
         self,
-        fileo: BinaryIO,
+        fileo: Union[BinaryIO, str, os.PathLike],
         schema: Union[str, TypeDescription],
         batch_size: int = 1024,
         stripe_size: int = 67108864,
@@ -32,7 +46,13 @@ class Writer(writer):
         padding_tolerance: float = 0.0,
         dict_key_size_threshold: float = 0.0,
         null_value: Any = None,
-        memory_block_size = 65536,
+        memory_block_size: int = 65536,
+        memory_pool: Optional[MemoryPool] = None,
+        collect_metrics: bool = False,
+        write_buffer_size: int = 8388608,
+        async_flush: bool = False,
+        sort_by: Optional[Sequence[str]] = None,
+        sort_buffer_rows: int = 262144,
     ) -> None:
         if isinstance(schema, str):
             schema = TypeDescription.from_string(schema)
@@ -40,6 +60,8 @@ class Writer(writer):
             raise TypeError("Invalid `schema` type, must be string or TypeDescription")
         if 0.0 >= bloom_filter_fpp or bloom_filter_fpp >= 1.0:
             raise ValueError("False positive probability should be > 0.0 & < 1.0")
+        if StructRepr(struct_repr) == StructRepr.COLUMNS:
+            raise ValueError("StructRepr.COLUMNS is not supported for writing")
         self.__schema = schema
         self.__user_metadata: Dict[str, bytes] = {}
         comp = CompressionKind(compression)
@@ -55,6 +77,19 @@ class Writer(writer):
                     bf_set.add(item)
                 elif isinstance(item, str):
                     bf_set.add(self.__schema.find_column_id(item))
+        sort_keys = []
+        if sort_by:
+            if isinstance(sort_by, str):
+                sort_by = [sort_by]
+            if self.__schema.kind != TypeKind.STRUCT:
+                raise TypeError("Sorting rows requires a struct schema")
+            field_names = list(self.__schema.fields)
+            for name in sort_by:
+                if name not in field_names:
+                    raise ValueError(
+                        "Sort field '{0}' is not in the schema".format(name)
+                    )
+                sort_keys.append(field_names.index(name))
         conv = None
         if converters:
             conv = DEFAULT_CONVERTERS.copy()
@@ -79,6 +114,12 @@ class Writer(writer):
             dict_key_size_threshold,
             null_value,
             memory_block_size,
+            memory_pool,
+            collect_metrics,
+            write_buffer_size,
+            async_flush,
+            sort_keys,
+            sort_buffer_rows,
         )
 
     def __enter__(self) -> "Writer":
@@ -103,3 +144,109 @@ class Writer(writer):
                     "All values must be bytes, key '{0}' is {1}".format(key, type(val))
                 )
             self.__user_metadata[key] = val
+
+    def write_batch(
+        self, columns: Mapping[str, Any], null_masks: Optional[Mapping[str, Any]] = None
+    ) -> int:
+        return super().write_batch(dict(columns), dict(null_masks or {}))
+
+
+class PartitionedWriter(partitioned_writer):
+    def __init__(
+        self,
+        schema: Union[str, TypeDescription],
+        partition_by: Union[str, Sequence[str]],
+        path_template: str,
+        max_open_files: Optional[int] = None,
+        memory_limit: Optional[int] = None,
+        max_rows: Optional[int] = None,
+        max_bytes: Optional[int] = None,
+        struct_repr: StructRepr = StructRepr.TUPLE,
+        memory_pool: Optional[MemoryPool] = None,
+        **writer_options: Any,
+    ) -> None:
+        if isinstance(schema, str):
+            schema = TypeDescription.from_string(schema)
+        elif not isinstance(schema, TypeDescription):
+            raise TypeError("Invalid `schema` type, must be string or TypeDescription")
+        if schema.kind != TypeKind.STRUCT:
+            raise TypeError("The `schema` of a PartitionedWriter must be a struct")
+        if isinstance(partition_by, str):
+            partition_by = [partition_by]
+        field_names = list(schema.fields)
+        for name in partition_by:
+            if name not in field_names:
+                raise ValueError(
+                    "Partition field '{0}' is not in the schema".format(name)
+                )
+        if "{seq" not in path_template:
+            raise ValueError("The `path_template` must contain a {seq} field")
+        for name, val in (
+            ("max_open_files", max_open_files),
+            ("memory_limit", memory_limit),
+            ("max_rows", max_rows),
+            ("max_bytes", max_bytes),
+        ):
+            if val is not None and val <= 0:
+                raise ValueError("The `{0}` must be positive".format(name))
+        if writer_options.get("async_flush"):
+            raise ValueError("PartitionedWriter does not support async_flush")
+        if memory_limit is not None and memory_pool is None:
+            memory_pool = MemoryPool()
+        self.__schema = schema
+        self.__paths: Dict[Tuple[Any, ...], List[str]] = {}
+        struct_repr = StructRepr(struct_repr)
+        if struct_repr == StructRepr.COLUMNS:
+            raise ValueError("StructRepr.COLUMNS is not supported for writing")
+        if struct_repr == StructRepr.TUPLE:
+            key_fields: List[Union[int, str]] = [
+                field_names.index(name) for name in partition_by
+            ]
+        else:
+            key_fields = list(partition_by)
+        options = dict(writer_options, struct_repr=struct_repr, memory_pool=memory_pool)
+        super().__init__(
+            self.__create_opener(
+                schema, tuple(partition_by), path_template, options, self.__paths
+            ),
+            key_fields,
+            memory_pool,
+            max_open_files or 0,
+            memory_limit or 0,
+            max_rows or 0,
+            max_bytes or 0,
+        )
+
+    @staticmethod
+    def __create_opener(
+        schema: TypeDescription,
+        partition_by: Tuple[str, ...],
+        path_template: str,
+        options: Dict[str, Any],
+        paths: Dict[Tuple[Any, ...], List[str]],
+    ) -> Callable[[Tuple[Any, ...], int], Writer]:
+        # The opener must not keep a reference to the PartitionedWriter.
+        def open_writer(key: Tuple[Any, ...], seq: int) -> Writer:
+            path = path_template.format(seq=seq, **dict(zip(partition_by, key)))
+            dirname = os.path.dirname(path)
+            if dirname:
+                os.makedirs(dirname, exist_ok=True)
+            wri = Writer(path, schema, **options)
+            paths.setdefault(key, []).append(path)
+            return wri
+
+        return open_writer
+
+    def __enter__(self) -> "PartitionedWriter":
+        return self
+
+    def __exit__(self, *exc: Any) -> None:
+        self.close()
+
+    @property
+    def schema(self) -> TypeDescription:
+        return copy.deepcopy(self.__schema)
+
+    @property
+    def paths(self) -> Dict[Tuple[Any, ...], List[str]]:
+        return {key: list(val) for key, val in self.__paths.items()}
@@ -0,0 +1,162 @@
+import pytest
+
+import io
+from decimal import Decimal
+
+from pyorc import (
+    CompressionKind,
+    PredicateColumn,
+    Reader,
+    TypeKind,
+    Writer,
+    concat,
+    rewrite,
+)
+
+
+def write_part(schema, rows, **kwargs):
+    data = io.BytesIO()
+    with Writer(data, schema, **kwargs) as writer:
+        writer.writerows(rows)
+    return data
+
+
+def test_concat_init():
+    part = write_part("struct<a:int>", [(0,)])
+    with pytest.raises(ValueError):
+        _ = concat([], io.BytesIO())
+    with pytest.raises(ValueError):
+        _ = concat([part], io.BytesIO(), sort_by=["a"])
+    other = write_part("struct<a:bigint>", [(0,)])
+    with pytest.raises(ValueError):
+        _ = concat([part, other], io.BytesIO())
+
+
+def test_concat():
+    schema = "struct<a:int,b:string,c:array<map<string,double>>>"
+    rows = [(i, str(i) * (i % 4), [{str(i): i / 3}] * (i % 3)) for i in range(5000)]
+    parts = [
+        write_part(schema, rows[:10], compression=CompressionKind.ZSTD),
+        write_part(schema, rows[10:3000], compression=CompressionKind.SNAPPY),
+        write_part(schema, []),
+        write_part(schema, rows[3000:]),
+    ]
+    out = io.BytesIO()
+    assert concat(parts, out, batch_size=100) == len(rows)
+    out.seek(0)
+    reader = Reader(out)
+    assert reader.compression == CompressionKind.ZSTD
+    assert list(reader) == rows
+
+
+def test_concat_paths(tmp_path):
+    paths = []
+    for idx in range(3):
+        part = write_part("struct<a:int>", [(idx * 10 + i,) for i in range(10)])
+        path = tmp_path / "part-{0}.orc".format(idx)
+        path.write_bytes(part.getvalue())
+        paths.append(str(path))
+    output = tmp_path / "out.orc"
+    assert concat(paths, output, compression=CompressionKind.NONE) == 30
+    with open(output, "rb") as fp:
+        reader = Reader(fp)
+        assert reader.compression == CompressionKind.NONE
+        assert list(reader) == [(i,) for i in range(30)]
+
+
+def test_concat_user_metadata():
+    parts = []
+    for idx in range(2):
+        data = io.BytesIO()
+        with Writer(data, "struct<a:int>") as writer:
+            writer.write((idx,))
+            writer.set_user_metadata(shared=str(idx).encode(), **{str(idx): b"x"})
+        parts.append(data)
+    out = io.BytesIO()
+    concat(parts, out)
+    out.seek(0)
+    assert Reader(out).user_metadata == {"shared": b"0", "0": b"x", "1": b"x"}
+
+
+def test_rewrite_init():
+    src = write_part("struct<a:int,b:string>", [(0, "a")])
+    with pytest.raises(ValueError):
+        _ = rewrite(src, io.BytesIO(), columns=["c"])
+    with pytest.raises(ValueError):
+        _ = rewrite(src, io.BytesIO(), columns=[])
+    with pytest.raises(ValueError):
+        _ = rewrite(src, io.BytesIO(), sort_by=["a"])
+    with pytest.raises(TypeError):
+        _ = rewrite(src, io.BytesIO(), predicate="wrong")
+    with pytest.raises(TypeError):
+        _ = rewrite(write_part("int", [0]), io.BytesIO())
+
+
+def test_rewrite():
+    schema = "struct<a:int,b:string,c:array<int>>"
+    rows = [(i, "s{0}".format(i), list(range(i % 5))) for i in range(3000)]
+    src = write_part(schema, rows, compression=CompressionKind.ZLIB)
+    dst = io.BytesIO()
+    assert (
+        rewrite(
+            src,
+            dst,
+            compression=CompressionKind.ZSTD,
+            row_index_stride=500,
+            bloom_filter_columns=["b"],
+        )
+        == 3000
+    )
+    dst.seek(0)
+    reader = Reader(dst)
+    assert reader.compression == CompressionKind.ZSTD
+    assert reader.row_index_stride == 500
+    assert list(reader) == rows
+    dst = io.BytesIO()
+    assert rewrite(src, dst, columns=["c", "a"]) == 3000
+    dst.seek(0)
+    reader = Reader(dst)
+    assert str(reader.schema) == "struct<a:int,c:array<int>>"
+    assert reader.compression == CompressionKind.ZLIB
+    assert list(reader) == [(row[0], row[2]) for row in rows]
+
+
+def test_rewrite_predicate():
+    schema = "struct<a:int,b:string,c:decimal(10,2),d:double>"
+    rows = [
+        (
+            i,
+            None if i % 7 == 0 else "v{0}".format(i % 10),
+            Decimal(i).scaleb(-2),
+            None if i % 11 == 0 else i / 2,
+        )
+        for i in range(2000)
+    ]
+    src = write_part(schema, rows, row_index_stride=100)
+    cases = [
+        (PredicateColumn(TypeKind.INT, "a") < 250, lambda row: row[0] < 250),
+        (
+            (PredicateColumn(TypeKind.STRING, "b") == "v3")
+            | (PredicateColumn(TypeKind.INT, "a") >= 1990),
+            lambda row: row[1] == "v3" or row[0] >= 1990,
+        ),
+        (
+            ~(PredicateColumn(TypeKind.STRING, "b") == "v3"),
+            lambda row: row[1] is not None and row[1] != "v3",
+        ),
+        (
+            PredicateColumn(TypeKind.DECIMAL, "c", precision=10, scale=3)
+            <= Decimal("1.005"),
+            lambda row: row[2] <= Decimal("1.005"),
+        ),
+        (
+            PredicateColumn(TypeKind.DOUBLE, index=4) > 900.0,
+            lambda row: row[3] is not None and row[3] > 900.0,
+        ),
+    ]
+    for predicate, check in cases:
+        dst = io.BytesIO()
+        expected = [(row[0],) for row in rows if check(row)]
+        assert rewrite(src, dst, columns=["a"], predicate=predicate) == len(expected)
+        dst.seek(0)
+        assert list(Reader(dst)) == expected
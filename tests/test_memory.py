@@ -0,0 +1,88 @@
+import pytest
+
+import io
+
+from pyorc import MemoryPool, Reader, Writer
+
+
+def test_init():
+    pool = MemoryPool()
+    assert pool.limit is None
+    assert pool.live_bytes == 0
+    assert pool.peak_bytes == 0
+    assert pool.cached_bytes == 0
+    assert pool.allocations == 0
+    pool = MemoryPool(limit=1024)
+    assert pool.limit == 1024
+    pool.limit = None
+    assert pool.limit is None
+    with pytest.raises(ValueError):
+        _ = MemoryPool(limit=0)
+    with pytest.raises(ValueError):
+        pool.limit = -1
+
+
+def test_accounting():
+    pool = MemoryPool()
+    data = io.BytesIO()
+    with Writer(data, "struct<a:int,b:string>", memory_pool=pool) as writer:
+        assert pool.live_bytes > 0
+        writer.writerows((i, str(i)) for i in range(50000))
+    del writer
+    assert pool.peak_bytes > 0
+    assert pool.live_bytes == 0
+    data.seek(0)
+    reader = Reader(data, memory_pool=pool)
+    assert sum(1 for _ in reader) == 50000
+    assert pool.live_bytes > 0
+    allocations = pool.allocations
+    del reader
+    assert pool.live_bytes == 0
+    assert pool.cached_bytes > 0
+    data.seek(0)
+    reader = Reader(data, batch_size=1024, memory_pool=pool)
+    _ = next(reader)
+    assert pool.allocations > allocations
+    # At least the integers, the string pointers and the string lengths.
+    assert pool.live_bytes >= 1024 * (8 + 8 + 8)
+    del reader
+    pool.reset_peak()
+    assert pool.peak_bytes == pool.live_bytes
+    pool.release()
+    assert pool.cached_bytes == 0
+
+
+def test_limit():
+    data = io.BytesIO()
+    with Writer(data, "struct<a:int,b:string>") as writer:
+        writer.writerows((i, str(i) * 10) for i in range(50000))
+    data.seek(0)
+    pool = MemoryPool(limit=4096)
+    with pytest.raises(MemoryError):
+        reader = Reader(data, batch_size=65535, memory_pool=pool)
+        _ = next(reader)
+    pool.limit = None
+    data.seek(0)
+    reader = Reader(data, batch_size=65535, memory_pool=pool)
+    assert len(reader.read()) == 50000
+
+
+def test_max_cached():
+    pool = MemoryPool(max_cached=0)
+    data = io.BytesIO()
+    with Writer(data, "int", memory_pool=pool) as writer:
+        writer.writerows(range(1000))
+    del writer
+    assert pool.live_bytes == 0
+    assert pool.cached_bytes == 0
+
+
+def test_writer_strings():
+    pool = MemoryPool()
+    writer = Writer(io.BytesIO(), "struct<a:string,b:binary>", memory_pool=pool)
+    live_bytes = pool.live_bytes
+    writer.write(("a" * 1000000, b"b" * 1000000))
+    assert pool.live_bytes >= live_bytes + 2000000
+    writer.close()
+    del writer
+    assert pool.live_bytes == 0
@@ -0,0 +1,128 @@
+import pytest
+
+import os
+
+from pyorc import MemoryPool, PartitionedWriter, Reader, StructRepr
+
+
+def read_rows(path):
+    with open(path, "rb") as fp:
+        return list(Reader(fp, struct_repr=StructRepr.DICT))
+
+
+def test_init(tmp_path):
+    template = str(tmp_path / "{a}" / "part-{seq}.orc")
+    with pytest.raises(TypeError):
+        _ = PartitionedWriter("int", "a", template)
+    with pytest.raises(TypeError):
+        _ = PartitionedWriter(0, "a", template)
+    with pytest.raises(ValueError):
+        _ = PartitionedWriter("struct<a:int,b:int>", "c", template)
+    with pytest.raises(ValueError):
+        _ = PartitionedWriter(
+            "struct<a:int,b:int>", "a", str(tmp_path / "{a}" / "part.orc")
+        )
+    with pytest.raises(ValueError):
+        _ = PartitionedWriter("struct<a:int,b:int>", "a", template, max_rows=0)
+    with pytest.raises(ValueError):
+        _ = PartitionedWriter("struct<a:int,b:int>", "a", template, async_flush=True)
+    with pytest.raises(ValueError):
+        _ = PartitionedWriter(
+            "struct<a:int,b:int>", "a", template, struct_repr=StructRepr.COLUMNS
+        )
+    writer = PartitionedWriter("struct<a:int,b:int>", ["a", "b"], template)
+    assert writer.open_partitions == 0
+    assert writer.current_row == 0
+    assert writer.paths == {}
+    assert str(writer.schema) == "struct<a:int,b:int>"
+
+
+def test_write(tmp_path):
+    template = str(tmp_path / "day={day}" / "kind={kind}" / "part-{seq:03d}.orc")
+    rows = [("2024-01-0{0}".format(i % 3), i % 2, i) for i in range(3000)]
+    with PartitionedWriter(
+        "struct<day:string,kind:int,value:bigint>", ["day", "kind"], template
+    ) as writer:
+        assert writer.writerows(rows) == 3000
+        assert writer.open_partitions == 6
+        assert writer.current_row == 3000
+    assert writer.open_partitions == 0
+    paths = writer.paths
+    assert len(paths) == 6
+    for (day, kind), files in paths.items():
+        assert files == [template.format(day=day, kind=kind, seq=0)]
+        expected = [
+            {"day": row[0], "kind": row[1], "value": row[2]}
+            for row in rows
+            if row[0] == day and row[1] == kind
+        ]
+        assert read_rows(files[0]) == expected
+
+
+def test_write_dict(tmp_path):
+    template = str(tmp_path / "{kind}-{seq}.orc")
+    with PartitionedWriter(
+        "struct<kind:string,value:int>",
+        "kind",
+        template,
+        struct_repr=StructRepr.DICT,
+        compression=0,
+    ) as writer:
+        for i in range(100):
+            writer.write({"kind": "odd" if i % 2 else "even", "value": i})
+    assert sorted(writer.paths) == [("even",), ("odd",)]
+    assert [row["value"] for row in read_rows(writer.paths[("odd",)][0])] == list(
+        range(1, 100, 2)
+    )
+
+
+def test_max_rows(tmp_path):
+    template = str(tmp_path / "{a}-{seq}.orc")
+    with PartitionedWriter(
+        "struct<a:int,b:int>", "a", template, max_rows=300
+    ) as writer:
+        writer.writerows((i % 2, i) for i in range(1000))
+    files = writer.paths[(0,)]
+    assert len(files) == 2
+    assert [len(read_rows(path)) for path in files] == [300, 200]
+    values = [row["b"] for path in files for row in read_rows(path)]
+    assert values == list(range(0, 1000, 2))
+
+
+def test_max_open_files(tmp_path):
+    template = str(tmp_path / "{a}-{seq}.orc")
+    with PartitionedWriter(
+        "struct<a:int,b:int>", "a", template, max_open_files=2
+    ) as writer:
+        for i in range(30):
+            writer.write((i % 3, i))
+            assert writer.open_partitions <= 2
+    files = writer.paths[(0,)]
+    assert len(files) == 10
+    values = [row["b"] for path in files for row in read_rows(path)]
+    assert values == list(range(0, 30, 3))
+
+
+def test_memory_limit(tmp_path):
+    template = str(tmp_path / "{a}-{seq}.orc")
+    pool = MemoryPool()
+    with PartitionedWriter(
+        "struct<a:int,b:string>",
+        "a",
+        template,
+        memory_limit=1,
+        memory_pool=pool,
+        memory_block_size=1024,
+    ) as writer:
+        writer.writerows((i % 4, str(i)) for i in range(400))
+        assert writer.open_partitions == 1
+    assert pool.live_bytes == 0
+    rows = [
+        (row["a"], row["b"])
+        for files in writer.paths.values()
+        for path in files
+        for row in read_rows(path)
+    ]
+    assert sorted(rows) == sorted((i % 4, str(i)) for i in range(400))
+    for files in writer.paths.values():
+        assert all(os.path.exists(path) for path in files)
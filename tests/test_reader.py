@@ -1,9 +1,10 @@
 import pytest
 
+import array
 import io
 import math
 import string
-from datetime import datetime, date, timezone
+from datetime import datetime, date, timedelta, timezone
 from decimal import Decimal
 
 import pyorc
@@ -19,6 +20,7 @@ from pyorc import (
     Stripe,
     CompressionKind,
     WriterVersion,
+    ReduceKind,
     orc_version,
 )
 from pyorc.converters import ORCConverter
@@ -187,6 +189,37 @@ def test_selected_schema():
     assert str(schema) == "struct<col1:string>"
 
 
+def test_wide_schema():
+    names = ["col{0}".format(idx) for idx in range(3000)]
+    schema_str = "struct<{0}>".format(
+        ",".join(
+            "{0}:{1}".format(name, "int" if idx % 2 else "string")
+            for idx, name in enumerate(names)
+        )
+    )
+    data = io.BytesIO()
+    with Writer(data, schema_str) as writer:
+        writer.writerows(
+            tuple(idx if idx % 2 else str(row) for idx in range(3000))
+            for row in range(20)
+        )
+    reader = Reader(data, struct_repr=StructRepr.DICT)
+    assert reader.schema is reader.schema
+    assert reader.selected_schema is reader.schema
+    assert str(reader.schema) == schema_str
+    assert reader.schema.find_column_id("col2999") == 3000
+    assert reader[3000].statistics["minimum"] == 2999
+    rows = reader.read()
+    assert len(rows) == 20
+    assert list(rows[5]) == names
+    assert rows[5]["col0"] == "5"
+    assert rows[5]["col2999"] == 2999
+    reader = Reader(data, column_names=["col1", "col2998"], struct_repr=StructRepr.DICT)
+    assert reader.selected_schema is reader.selected_schema
+    assert str(reader.selected_schema) == "struct<col1:int,col2998:string>"
+    assert next(reader) == {"col1": 1, "col2998": "0"}
+
+
 def test_current_row(orc_data):
     reader = Reader(orc_data(20))
     assert reader.current_row == 0
@@ -270,6 +303,213 @@ def test_read(orc_data):
     assert len(result) == len(reader)
 
 
+def test_take(striped_orc_data):
+    num = 200000
+    reader = Reader(striped_orc_data(num), batch_size=1000)
+    assert reader.take([]) == []
+    rows = [150000, 3, 199999, 3, 0, 70001, 70002, 12345, 150000]
+    assert reader.take(rows) == [(row,) for row in rows]
+    assert reader.take(iter(range(10, 5000, 7))) == [
+        (row,) for row in range(10, 5000, 7)
+    ]
+    assert reader.current_row == 0
+    assert next(reader) == (0,)
+    reader.seek(500)
+    assert reader.take([100]) == [(100,)]
+    assert next(reader) == (500,)
+    with pytest.raises(IndexError):
+        _ = reader.take([num])
+    with pytest.raises(TypeError):
+        _ = reader.take([-1])
+    reader = Reader(
+        striped_orc_data(10), predicate=PredicateColumn(TypeKind.INT, "col0") > 5
+    )
+    with pytest.raises(ValueError):
+        _ = reader.take([6])
+
+
+def test_seek_key():
+    data = io.BytesIO()
+    with Writer(
+        data,
+        "struct<k:bigint,v:int,n:struct<s:string>>",
+        batch_size=1000,
+        stripe_size=128,
+        compression_block_size=128,
+        memory_block_size=64,
+        row_index_stride=1000,
+    ) as writer:
+        writer.writerows(
+            (None if i < 100 else i // 3, i, ("{0:06d}".format(i),))
+            for i in range(60000)
+        )
+    reader = Reader(data, batch_size=100)
+    assert reader.num_of_stripes > 1
+    assert reader.seek_key("k", 5000) == 15000
+    assert reader.current_row == 15000
+    assert next(reader) == (5000, 15000, ("015000",))
+    assert reader.seek_key("k", 4999.5) == 15000
+    assert reader.seek_key(1, 0) == 100
+    assert next(reader) == (33, 100, ("000100",))
+    assert reader.seek_key("k", 19999) == 59997
+    assert reader.read() == [
+        (19999, i, ("{0:06d}".format(i),)) for i in (59997, 59998, 59999)
+    ]
+    assert reader.seek_key("k", 20000) == 60000
+    with pytest.raises(StopIteration):
+        _ = next(reader)
+    assert reader.seek_key("n.s", "031337") == 31337
+    assert next(reader)[1] == 31337
+    assert reader.seek_key("v", 12345) == 12345
+    assert next(reader)[1] == 12345
+    with pytest.raises(TypeError):
+        _ = reader.seek_key("k", "wrong")
+    with pytest.raises(IndexError):
+        _ = reader.seek_key(10, 0)
+    reader = Reader(data, column_names=["v"])
+    with pytest.raises(ValueError):
+        _ = reader.seek_key("k", 0)
+    assert reader.seek_key("v", 100) == 100
+    assert next(reader) == (100,)
+    with pytest.raises(ValueError):
+        _ = Reader(data, metadata_only=True).seek_key("k", 0)
+
+
+def test_seek_key_wrong_column():
+    data = io.BytesIO()
+    with Writer(data, "struct<a:int,b:array<int>,c:boolean>") as writer:
+        writer.write((0, [0], True))
+    reader = Reader(data)
+    with pytest.raises(ValueError):
+        _ = reader.seek_key(3, 0)
+    with pytest.raises(ValueError):
+        _ = reader.seek_key("c", True)
+    with pytest.raises(ValueError):
+        _ = reader.seek_key(0, 0)
+
+
+def test_struct_repr_columns():
+    data = io.BytesIO()
+    schema = "struct<a:int,b:string,c:struct<x:double,y:array<int>>>"
+    rows = [
+        (i, "Test {0}".format(i) if i % 3 else None, (i / 2, [i]))
+        for i in range(2500)
+    ]
+    with Writer(data, schema) as writer:
+        writer.writerows(rows)
+    reader = Reader(data, batch_size=1000, struct_repr=StructRepr.COLUMNS)
+    batches = list(reader.iter_batches())
+    assert [len(batch["a"]) for batch in batches] == [1000, 1000, 500]
+    assert batches[1]["a"] == list(range(1000, 2000))
+    assert batches[2]["c"][-1] == {"x": 2499 / 2, "y": [2499]}
+    reader = Reader(data, batch_size=1000, struct_repr=StructRepr.COLUMNS)
+    assert next(reader) == {"a": 0, "b": None, "c": {"x": 0.0, "y": [0]}}
+    result = reader.read(1500)
+    assert list(result) == ["a", "b", "c"]
+    assert result["a"] == list(range(1, 1501))
+    assert result["b"] == [row[1] for row in rows[1:1501]]
+    assert reader.current_row == 1501
+    assert next(reader)["a"] == 1501
+    result = reader.read()
+    assert result["c"] == [{"x": row[2][0], "y": row[2][1]} for row in rows[1502:]]
+    assert reader.read() == {"a": [], "b": [], "c": []}
+    reader = Reader(data, column_names=["b"], struct_repr=StructRepr.COLUMNS)
+    assert reader.read(3) == {"b": [None, "Test 1", "Test 2"]}
+    stripe = Reader(data, struct_repr=StructRepr.COLUMNS).read_stripe(0)
+    assert stripe.read()["a"] == list(range(2500))
+    reader = Reader(data, batch_size=1000)
+    assert [len(batch) for batch in reader.iter_batches()] == [1000, 1000, 500]
+    data = io.BytesIO()
+    with Writer(data, "int") as writer:
+        writer.write(0)
+    with pytest.raises(ValueError):
+        _ = Reader(data, struct_repr=StructRepr.COLUMNS)
+
+
+def test_tight_numeric_vector():
+    data = io.BytesIO()
+    schema = (
+        "struct<a:boolean,b:tinyint,c:smallint,d:int,e:bigint,f:float,g:double,"
+        "h:array<smallint>,i:date>"
+    )
+    rows = [
+        (
+            i % 3 == 0 if i % 5 else None,
+            i % 256 - 128,
+            i * 3 - 30000,
+            i * -70001 if i % 7 else None,
+            i * 2**40,
+            i / 4,
+            i / 3,
+            [i % 100, -i % 100],
+            date(2000, 1, 1) + timedelta(days=i),
+        )
+        for i in range(20000)
+    ]
+    with Writer(data, schema) as writer:
+        writer.writerows(rows)
+    reader = Reader(data, batch_size=3000, tight_numeric_vector=True)
+    assert reader.read() == rows
+    reader = Reader(
+        data, struct_repr=StructRepr.COLUMNS, tight_numeric_vector=True
+    )
+    result = reader.read()
+    assert result["c"] == [row[2] for row in rows]
+    assert result["f"] == [row[5] for row in rows]
+    reader = Reader(data, tight_numeric_vector=True)
+    assert reader.take([19999, 3]) == [rows[19999], rows[3]]
+    assert reader.seek_key("c", 0) == 10000
+    assert next(reader) == rows[10000]
+    stripe = reader.read_stripe(0)
+    assert stripe.read() == rows[: len(stripe)]
+
+
+@pytest.mark.parametrize("tight", [False, True])
+def test_numeric_arrays(tight):
+    data = io.BytesIO()
+    schema = (
+        "struct<a:array<float>,b:array<bigint>,c:array<tinyint>,"
+        "d:array<string>,e:map<string,array<double>>>"
+    )
+    rows = [
+        (
+            [i / 2, i / 4] if i % 3 else None,
+            [i * 2**33, None] if i % 4 == 0 else list(range(i % 5)),
+            [i % 100, -(i % 100)],
+            [str(i)],
+            {"x": [i / 8] * 3},
+        )
+        for i in range(3000)
+    ]
+    with Writer(data, schema) as writer:
+        writer.writerows(rows)
+    reader = Reader(data, numeric_arrays=True, tight_numeric_vector=tight)
+    result = reader.read()
+    assert len(result) == len(rows)
+    for row, expected in zip(result, rows):
+        if expected[0] is None:
+            assert row[0] is None
+        else:
+            assert isinstance(row[0], array.array)
+            assert row[0].typecode in ("f", "d")
+            assert row[0].tolist() == expected[0]
+        if None in expected[1]:
+            assert row[1] == expected[1]
+        else:
+            assert row[1].typecode == "q"
+            assert row[1].tolist() == expected[1]
+        assert row[2].typecode in ("b", "q")
+        assert row[2].tolist() == expected[2]
+        assert row[3] == expected[3]
+        assert row[4]["x"] == array.array("d", expected[4]["x"])
+    stripe = Reader(data, numeric_arrays=True).read_stripe(0)
+    assert next(stripe)[1] == [0, None]
+    assert next(stripe)[1] == array.array("q", [0])
+    result = Reader(data, struct_repr=StructRepr.COLUMNS, numeric_arrays=True).read()
+    assert result["c"][10] == array.array("q", [10, -10])
+    assert Reader(data).read() == rows
+
+
 def test_include():
     data = io.BytesIO()
     record = {"col0": 1, "col1": "Test A", "col2": 3.14}
@@ -632,3 +872,174 @@ def test_read_custom_null_value(orc_type, value):
     else:
         assert next(reader) == value
     assert next(reader) is NullValue()
+
+
+def test_reduce(striped_orc_data):
+    num = 655350
+    reader = Reader(striped_orc_data(num))
+    result = reader.reduce(1, ReduceKind.COUNT)
+    assert result["file"] == num
+    assert len(result["stripes"]) == reader.num_of_stripes
+    assert sum(result["stripes"]) == num
+    result = reader.reduce("col0", ReduceKind.SUM)
+    assert result["file"] == sum(range(num))
+    assert sum(result["stripes"]) == result["file"]
+    result = reader.reduce("col0", ReduceKind.HISTOGRAM, bins=5)
+    assert len(result["file"]) == 5
+    assert sum(result["file"]) == num
+    assert all(abs(cnt - num // 5) <= 1 for cnt in result["file"])
+    assert result["bin_edges"][0] == 0
+    assert result["bin_edges"][-1] == pytest.approx(num - 1)
+    result = reader.reduce("col0", ReduceKind.DISTINCT)
+    assert abs(result["file"] - num) < num * 0.03
+
+
+def test_reduce_nested_and_nulls():
+    data = io.BytesIO()
+    with Writer(data, "struct<col0:double,col1:string,col2:array<int>>") as writer:
+        for i in range(1000):
+            writer.write(
+                (i / 2 if i % 4 else None, "Test {0}".format(i % 100), [i, i])
+            )
+    reader = Reader(data)
+    assert reader.reduce("col0", ReduceKind.COUNT)["file"] == 750
+    assert reader.reduce("col0", ReduceKind.SUM)["file"] == pytest.approx(
+        sum(i / 2 for i in range(1000) if i % 4)
+    )
+    assert abs(reader.reduce("col1", ReduceKind.DISTINCT)["file"] - 100) <= 2
+    assert reader.reduce(4, ReduceKind.SUM)["file"] == 2 * sum(range(1000))
+    assert reader.reduce(0, ReduceKind.COUNT)["file"] == 1000
+    with pytest.raises(TypeError):
+        _ = reader.reduce("col1", ReduceKind.SUM)
+    with pytest.raises(TypeError):
+        _ = reader.reduce("col2", ReduceKind.DISTINCT)
+    with pytest.raises(IndexError):
+        _ = reader.reduce(10, ReduceKind.COUNT)
+    with pytest.raises(KeyError):
+        _ = reader.reduce("col5", ReduceKind.COUNT)
+    with pytest.raises(ValueError):
+        _ = reader.reduce("col0", 9)
+    with pytest.raises(ValueError):
+        _ = reader.reduce("col0", ReduceKind.HISTOGRAM, bins=0)
+
+
+def test_reduce_histogram_without_bounds():
+    data = io.BytesIO()
+    with Writer(data, "struct<col0:double>") as writer:
+        writer.write((float("nan"),))
+        writer.writerows((float(i),) for i in range(1000))
+    result = Reader(data).reduce("col0", ReduceKind.HISTOGRAM, bins=4)
+    assert result["file"] == [250, 250, 250, 250]
+    assert result["bin_edges"][0] == 0
+    assert result["bin_edges"][-1] == 999
+
+
+def test_stripe_statistics():
+    data = io.BytesIO()
+    with Writer(
+        data,
+        "struct<a:int,b:double,c:string,d:boolean,e:array<int>>",
+        stripe_size=128,
+        compression_block_size=128,
+        memory_block_size=64,
+    ) as writer:
+        writer.writerows(
+            (i, i / 2 if i % 3 else None, str(i % 700), i % 2 == 0, [i])
+            for i in range(100000)
+        )
+    reader = Reader(data)
+    num = reader.num_of_stripes
+    assert num > 1
+    result = reader.stripe_statistics(["a", 2, "c", "d", "e", 0])
+    assert list(result) == ["a", 2, "c", "d", "e", 0]
+    for idx, stripe in enumerate(reader.iter_stripes()):
+        for col, col_id in (("a", 1), (2, 2), ("c", 3)):
+            expected = stripe[col_id].statistics
+            assert result[col]["kind"] == expected["kind"]
+            assert result[col]["minimum"][idx] == expected["minimum"]
+            assert result[col]["maximum"][idx] == expected["maximum"]
+            assert result[col]["number_of_values"][idx] == expected["number_of_values"]
+        assert result["a"]["sum"][idx] == stripe[1].statistics["sum"]
+        assert result["d"]["true_count"][idx] == stripe[4].statistics["true_count"]
+        assert result["c"]["total_length"][idx] == stripe[3].statistics["total_length"]
+    assert isinstance(result["a"]["minimum"], array.array)
+    assert result["a"]["minimum"].typecode == "q"
+    assert result[2]["sum"].typecode == "d"
+    assert isinstance(result["c"]["minimum"], list)
+    assert list(result[2]["has_null"]) == [1] * num
+    assert list(result["a"]["has_null"]) == [0] * num
+    assert sum(result["a"]["number_of_values"]) == 100000
+    assert result["e"]["kind"] == TypeKind.LIST
+    assert sum(result[0]["number_of_values"]) == 100000
+    assert reader.stripe_statistics("a")["a"]["minimum"][0] == 0
+    with pytest.raises(IndexError):
+        _ = reader.stripe_statistics([10])
+    with pytest.raises(KeyError):
+        _ = reader.stripe_statistics(["f"])
+    reader = Reader(data, column_indices=[2])
+    selected = reader.stripe_statistics([3])
+    assert selected[3]["total_length"] == result["c"]["total_length"]
+    with pytest.raises(IndexError):
+        _ = reader.stripe_statistics([1])
+    with pytest.raises(IndexError):
+        _ = reader.read_stripe(0)[1]
+
+
+def test_metrics(striped_orc_data):
+    num = 200000
+    data = striped_orc_data(num)
+    assert Reader(data).metrics is None
+    reader = Reader(data, collect_metrics=True)
+    metrics = reader.metrics
+    assert metrics["conversion_call"] == 0
+    assert len(reader.read()) == num
+    metrics = reader.metrics
+    assert metrics["conversion_call"] == num
+    assert metrics["conversion_latency_us"] > 0
+    stripe = reader.read_stripe(1)
+    rows = len(stripe.read())
+    assert reader.metrics["conversion_call"] == num + rows
+    if (pyorc.orc_version_info.major, pyorc.orc_version_info.minor) >= (1, 9):
+        assert metrics["reader_call"] > 0
+        assert metrics["decompression_call"] > 0
+        assert metrics["decoding_call"] > 0
+        assert metrics["io_count"] > 0
+        assert reader.metrics["reader_call"] > metrics["reader_call"]
+    else:
+        assert "reader_call" not in metrics
+
+
+def test_metadata_only(striped_orc_data):
+    num = 200000
+    data = striped_orc_data(num)
+    reader = Reader(data, predicate="wrong", metadata_only=True)
+    assert len(reader) == num
+    assert str(reader.schema) == "struct<col0:int>"
+    assert str(reader.selected_schema) == "struct<col0:int>"
+    assert reader.num_of_stripes > 1
+    assert reader[1].statistics["number_of_values"] == num
+    assert reader.user_metadata == {}
+    with pytest.raises(ValueError):
+        _ = next(reader)
+    with pytest.raises(ValueError):
+        _ = reader.read()
+    with pytest.raises(ValueError):
+        _ = reader.seek(10)
+    assert reader.current_row == 0
+    reader = Reader(data, column_indices=[0], metadata_only=True)
+    assert str(reader.selected_schema) == "struct<col0:int>"
+    assert reader.read_stripe(1)[1].statistics["kind"] == TypeKind.INT
+    stripe = reader.read_stripe(1)
+    expected = Reader(data).read_stripe(1)
+    assert len(stripe) == len(expected)
+    assert stripe.row_offset == expected.row_offset > 0
+    assert stripe.bytes_length == expected.bytes_length
+    with pytest.raises(ValueError):
+        _ = next(stripe)
+    with pytest.raises(ValueError):
+        _ = stripe.read()
+    with pytest.raises(ValueError):
+        _ = stripe.seek(10)
+    assert stripe.current_row == 0
+    with pytest.raises(ValueError):
+        _ = Reader(data, column_indices=[10], metadata_only=True)
@@ -0,0 +1,110 @@
+import pytest
+
+import io
+import os
+
+from pyorc import Reader, Writer, sort_files
+
+
+def write_parts(schema, rows, num_parts):
+    parts = []
+    for idx in range(num_parts):
+        data = io.BytesIO()
+        with Writer(data, schema) as writer:
+            writer.writerows(rows[idx::num_parts])
+        parts.append(data)
+    return parts
+
+
+def test_init(tmp_path):
+    part = write_parts("struct<a:int,b:array<int>>", [(0, [0])], 1)[0]
+    with pytest.raises(ValueError):
+        _ = sort_files([], io.BytesIO(), ["a"])
+    with pytest.raises(ValueError):
+        _ = sort_files([part], io.BytesIO(), [])
+    with pytest.raises(ValueError):
+        _ = sort_files([part], io.BytesIO(), ["c"])
+    with pytest.raises(ValueError):
+        _ = sort_files([part], io.BytesIO(), ["b"])
+    with pytest.raises(ValueError):
+        _ = sort_files([part], io.BytesIO(), ["a"], memory_limit=0)
+    with pytest.raises(ValueError):
+        _ = sort_files([part], io.BytesIO(), ["a"], sort_by=["a"])
+    with pytest.raises(TypeError):
+        _ = sort_files(write_parts("int", [0], 1), io.BytesIO(), ["a"])
+    other = write_parts("struct<a:int,b:string>", [(0, "a")], 1)[0]
+    with pytest.raises(ValueError):
+        _ = sort_files([part, other], io.BytesIO(), ["a"])
+
+
+@pytest.mark.parametrize("memory_limit", [1, 1048576, 268435456])
+def test_sort_files(memory_limit):
+    schema = "struct<a:string,b:int,c:array<string>,d:map<string,double>>"
+    rows = [
+        (
+            None if i % 17 == 0 else "key{0}".format(i * 7919 % 300),
+            i,
+            [str(i)] * (i % 3),
+            {str(i): i / 2} if i % 5 else None,
+        )
+        for i in range(6000)
+    ]
+    parts = write_parts(schema, rows, 3)
+    out = io.BytesIO()
+    assert (
+        sort_files(parts, out, "a", memory_limit=memory_limit, batch_size=100)
+        == len(rows)
+    )
+    out.seek(0)
+    result = list(Reader(out))
+    inputs = [row for part in range(3) for row in rows[part::3]]
+    assert result == sorted(inputs, key=lambda row: (row[0] is not None, row[0] or ""))
+
+
+def test_sort_files_paths(tmp_path):
+    rows = [((i * 31) % 50, (i * 7) % 3, i) for i in range(2000)]
+    paths = []
+    for idx, part in enumerate(write_parts("struct<a:int,b:int,c:bigint>", rows, 4)):
+        path = tmp_path / "part-{0}.orc".format(idx)
+        path.write_bytes(part.getvalue())
+        paths.append(str(path))
+    output = tmp_path / "sorted.orc"
+    spill_dir = tmp_path / "spill"
+    spill_dir.mkdir()
+    assert (
+        sort_files(
+            paths,
+            output,
+            ["a", "b"],
+            memory_limit=1,
+            batch_size=100,
+            tmp_dir=str(spill_dir),
+            compression=0,
+        )
+        == 2000
+    )
+    assert os.listdir(spill_dir) == []
+    with open(output, "rb") as fp:
+        reader = Reader(fp)
+        assert reader.compression == 0
+        result = list(reader)
+    inputs = [row for part in range(4) for row in rows[part::4]]
+    assert result == sorted(inputs, key=lambda row: (row[0], row[1]))
+
+
+def test_sort_files_multiple_passes(tmp_path):
+    rows = [(i % 7, "value {0}".format(i)) for i in range(3000)]
+    parts = write_parts("struct<a:int,b:string>", rows, 2)
+    out = io.BytesIO()
+    # Two rows in a batch make runs of 32 rows, more than 64 of them.
+    assert (
+        sort_files(
+            parts, out, "a", memory_limit=1, batch_size=2, tmp_dir=str(tmp_path)
+        )
+        == 3000
+    )
+    assert os.listdir(tmp_path) == []
+    out.seek(0)
+    reader = Reader(out)
+    inputs = [row for part in range(2) for row in rows[part::2]]
+    assert list(reader) == sorted(inputs, key=lambda row: row[0])
@@ -1,9 +1,12 @@
 import pytest
 
+import array
 import io
 import math
 import os
-from datetime import date, datetime, timezone
+import pathlib
+import threading
+from datetime import date, datetime, timedelta, timezone
 from decimal import Decimal
 
 try:
@@ -14,6 +17,7 @@ except ImportError:
 from pyorc import (
     Writer,
     Reader,
+    PredicateColumn,
     TypeDescription,
     ParseError,
     TypeKind,
@@ -22,7 +26,12 @@ from pyorc import (
     orc_version,
     orc_version_info,
 )
-from pyorc.converters import ORCConverter
+from pyorc.converters import (
+    ORCConverter,
+    DateConverter,
+    DecimalConverter,
+    TimestampConverter,
+)
 
 from conftest import output_file, NullValue
 
@@ -434,6 +443,8 @@ def test_struct_repr():
         writer.write((1,))
     with pytest.raises(TypeError):
         writer.write({"a": "b"})
+    with pytest.raises(ValueError):
+        _ = Writer(data, "struct<a:int>", struct_repr=StructRepr.COLUMNS)
 
 
 class TestConverter(ORCConverter):
@@ -642,3 +653,616 @@ def test_write_intermediate_footer():
     reader = Reader(data)
     assert len(reader) == 65536
     assert reader.bytes_lengths["file_length"] >= offset
+
+
+def test_metrics(output_file):
+    writer = Writer(io.BytesIO(), "struct<a:int,b:string>")
+    assert writer.metrics is None
+    data = io.BytesIO()
+    writer = Writer(
+        data,
+        "struct<a:int,b:string>",
+        batch_size=1000,
+        stripe_size=1024,
+        compression_block_size=1024,
+        memory_block_size=512,
+        collect_metrics=True,
+    )
+    writer.writerows((i, "Test {0}".format(i)) for i in range(50000))
+    metrics = writer.metrics
+    assert metrics["conversion_call"] == 50000
+    assert metrics["add_call"] == 50
+    assert "stripes" not in metrics
+    writer.close()
+    metrics = writer.metrics
+    assert metrics["bytes_written"] == len(data.getvalue())
+    assert metrics["io_call"] > 0
+    assert metrics["stripes"] == Reader(data).num_of_stripes
+    assert metrics["stripes"] > 1
+    assert sorted(metrics["column_sizes"]) == [0, 1, 2]
+    assert metrics["column_sizes"][2] > metrics["column_sizes"][0]
+    assert sum(metrics["column_sizes"].values()) <= metrics["bytes_written"]
+    output_file.close()
+    with open(output_file.name, "wb") as fp:
+        with Writer(fp, "int", collect_metrics=True) as writer:
+            writer.writerows(range(1000))
+    assert writer.metrics["conversion_call"] == 1000
+    assert "column_sizes" not in writer.metrics
+
+
+def test_metrics_not_seekable():
+    class ReadableOnly:
+        closed = False
+
+        def __init__(self):
+            self.data = io.BytesIO()
+
+        def write(self, buf):
+            return self.data.write(buf)
+
+        def flush(self):
+            pass
+
+        def readable(self):
+            return True
+
+    fileo = ReadableOnly()
+    with Writer(fileo, "int", collect_metrics=True) as writer:
+        writer.writerows(range(1000))
+    assert writer.metrics["conversion_call"] == 1000
+    assert "column_sizes" not in writer.metrics
+    assert list(Reader(fileo.data)) == list(range(1000))
+
+
+def test_write_batch():
+    data = io.BytesIO()
+    writer = Writer(
+        data,
+        "struct<a:int,b:double,c:string,d:boolean,e:binary>",
+        batch_size=100,
+    )
+    writer.write((-1, -1.0, "first", False, b"\x00"))
+    num = 1050
+    text = "".join(str(i) for i in range(num)).encode()
+    offsets = array.array("q", [0])
+    for i in range(num):
+        offsets.append(offsets[-1] + len(str(i)))
+    bitmap = bytearray((num + 7) // 8)
+    for i in range(0, num, 3):
+        bitmap[i // 8] |= 1 << (i % 8)
+    res = writer.write_batch(
+        {
+            "a": array.array("i", range(num)),
+            "b": array.array("f", (i / 2 for i in range(num))),
+            "c": (offsets, text),
+            "d": bytes(i % 2 for i in range(num)),
+            "e": (array.array("i", offsets), memoryview(text)),
+        },
+        null_masks={"b": bytes(i % 5 != 0 for i in range(num)), "c": bitmap},
+    )
+    assert res == num
+    assert writer.current_row == num + 1
+    writer.write((num, None, "last", True, b"\xff"))
+    writer.close()
+    data.seek(0)
+    result = Reader(data).read()
+    assert len(result) == num + 2
+    assert result[0] == (-1, -1.0, "first", False, b"\x00")
+    assert result[-1] == (num, None, "last", True, b"\xff")
+    for i, row in enumerate(result[1:-1]):
+        assert row == (
+            i,
+            i / 2 if i % 5 != 0 else None,
+            str(i) if i % 3 == 0 else None,
+            bool(i % 2),
+            str(i).encode(),
+        )
+
+
+def test_write_batch_errors():
+    writer = Writer(io.BytesIO(), "struct<a:int,b:string>")
+    ints = array.array("i", [0, 1, 2])
+    strs = (array.array("i", [0, 1, 2, 3]), b"abc")
+    with pytest.raises(ValueError):
+        writer.write_batch({"a": ints})
+    with pytest.raises(ValueError):
+        writer.write_batch({"a": array.array("i", [0, 1]), "b": strs})
+    with pytest.raises(TypeError):
+        writer.write_batch({"a": [0, 1, 2], "b": strs})
+    with pytest.raises(TypeError):
+        writer.write_batch({"a": array.array("d", [0, 1, 2]), "b": strs})
+    with pytest.raises(TypeError):
+        writer.write_batch({"a": ints, "b": ["a", "b", "c"]})
+    with pytest.raises(ValueError):
+        writer.write_batch({"a": ints, "b": (array.array("i", [0, 1, 5, 3]), b"abc")})
+    with pytest.raises(ValueError):
+        writer.write_batch({"a": ints, "b": strs}, null_masks={"a": b"\x01\x01"})
+    with pytest.raises(TypeError):
+        writer.write_batch({"a": ints, "b": strs}, null_masks={"a": [True] * 3})
+    with pytest.raises(ValueError):
+        writer.write_batch(
+            {"a": array.array("Q", [2**63, 0, 0]), "b": strs},
+        )
+    assert writer.write_batch({"a": ints, "b": strs}) == 3
+    with pytest.raises(TypeError):
+        Writer(io.BytesIO(), "int").write_batch({"": ints})
+    with pytest.raises(TypeError):
+        Writer(io.BytesIO(), "struct<a:array<int>>").write_batch({"a": ints})
+
+
+def test_write_batch_invalid_value():
+    data = io.BytesIO()
+    writer = Writer(data, "struct<a:bigint,b:boolean>", batch_size=100)
+    flags = memoryview(bytes([0, 2] * 500)).cast("?")
+    assert writer.write_batch({"a": array.array("Q", range(1000)), "b": flags}) == 1000
+    with pytest.raises(ValueError):
+        values = array.array("Q", range(1000))
+        values[150] = 2**63
+        writer.write_batch({"a": values, "b": flags})
+    assert writer.current_row == 1000
+    writer.close()
+    assert list(Reader(data)) == [(i, i % 2 == 1) for i in range(1000)]
+
+
+def test_write_arrow():
+    pa = pytest.importorskip("pyarrow")
+    num = 2500
+    schema = (
+        "struct<a:int,b:double,c:string,d:string,e:timestamp,f:date,"
+        "g:array<bigint>,h:map<string,int>,i:struct<x:boolean,y:decimal(10,2)>>"
+    )
+    table = pa.table(
+        {
+            "i": pa.array(
+                [
+                    {"x": i % 2 == 0, "y": Decimal(i) / 100} if i % 7 else None
+                    for i in range(num)
+                ],
+                type=pa.struct([("x", pa.bool_()), ("y", pa.decimal128(10, 2))]),
+            ),
+            "a": pa.array([i if i % 3 else None for i in range(num)], pa.int32()),
+            "b": pa.array([i / 4 for i in range(num)], pa.float32()),
+            "c": pa.array(["Test {0}".format(i) for i in range(num)], pa.large_utf8()),
+            "d": pa.array(
+                ["A" if i % 2 else "B" for i in range(num)]
+            ).dictionary_encode(),
+            "e": pa.array(
+                [i * 1_000_001 - 10 for i in range(num)], pa.timestamp("us", tz="UTC")
+            ),
+            "f": pa.array([i - 100 for i in range(num)], pa.date32()),
+            "g": pa.array(
+                [list(range(i % 5)) if i % 11 else None for i in range(num)],
+                pa.list_(pa.int64()),
+            ),
+            "h": pa.array(
+                [[("k{0}".format(i), i)] for i in range(num)],
+                pa.map_(pa.utf8(), pa.int32()),
+            ),
+        }
+    )
+    table = pa.concat_tables([table.slice(0, 1000), table.slice(1000)])
+    data = io.BytesIO()
+    with Writer(data, schema, batch_size=256) as writer:
+        assert writer.write_arrow(table) == num
+        assert writer.write_arrow(table.to_batches()[1].slice(10, 5)) == 5
+    data.seek(0)
+    result = Reader(data, struct_repr=StructRepr.DICT).read()
+    assert len(result) == num + 5
+    for i, row in enumerate(result[:num]):
+        assert row["a"] == (i if i % 3 else None)
+        assert row["b"] == i / 4
+        assert row["c"] == "Test {0}".format(i)
+        assert row["d"] == ("A" if i % 2 else "B")
+        assert row["e"] == datetime.fromtimestamp(
+            0, timezone.utc
+        ) + timedelta(microseconds=i * 1_000_001 - 10)
+        assert row["f"] == date(1970, 1, 1) + timedelta(days=i - 100)
+        assert row["g"] == (list(range(i % 5)) if i % 11 else None)
+        assert row["h"] == {"k{0}".format(i): i}
+        assert row["i"] == (
+            {"x": i % 2 == 0, "y": Decimal(i) / 100} if i % 7 else None
+        )
+    assert [row["c"] for row in result[num:]] == [
+        "Test {0}".format(i) for i in range(1010, 1015)
+    ]
+
+
+def test_write_arrow_errors():
+    pa = pytest.importorskip("pyarrow")
+    writer = Writer(io.BytesIO(), "struct<a:int,b:string>")
+    with pytest.raises(TypeError):
+        writer.write_arrow([(0, "a")])
+    with pytest.raises(ValueError):
+        writer.write_arrow(pa.table({"a": pa.array([0], pa.int32())}))
+    with pytest.raises(TypeError):
+        writer.write_arrow(
+            pa.table({"a": pa.array(["0"]), "b": pa.array(["a"])})
+        )
+    with pytest.raises(ValueError):
+        writer.write_arrow(
+            pa.table({"a": pa.array([2**63], pa.uint64()), "b": pa.array(["a"])})
+        )
+    assert writer.write_arrow(pa.table({"b": ["a"], "a": [0], "c": [1.0]})) == 1
+
+
+def test_write_arrow_invalid_value():
+    pa = pytest.importorskip("pyarrow")
+    data = io.BytesIO()
+    writer = Writer(
+        data, "struct<a:bigint,b:array<decimal(10,2)>>", batch_size=100
+    )
+    valid = pa.table(
+        {
+            "a": pa.array(list(range(1000)), pa.uint64()),
+            "b": pa.array(
+                [[Decimal(i)] for i in range(1000)], pa.list_(pa.decimal128(20, 2))
+            ),
+        }
+    )
+    assert writer.write_arrow(valid) == 1000
+    with pytest.raises(ValueError):
+        writer.write_arrow(
+            pa.record_batch(
+                {
+                    "a": pa.array(list(range(999)) + [2**63], pa.uint64()),
+                    "b": valid.column("b").combine_chunks(),
+                }
+            )
+        )
+    with pytest.raises(ValueError):
+        writer.write_arrow(
+            pa.record_batch(
+                {
+                    "a": valid.column("a").combine_chunks(),
+                    "b": pa.array(
+                        [[Decimal(i)] for i in range(999)] + [[Decimal(10**17)]],
+                        pa.list_(pa.decimal128(20, 2)),
+                    ),
+                }
+            )
+        )
+    assert writer.current_row == 1000
+    writer.close()
+    assert list(Reader(data)) == [(i, [Decimal(i)]) for i in range(1000)]
+
+
+def test_write_path(output_file):
+    output_file.close()
+    with Writer(output_file.name, "struct<a:int>") as writer:
+        writer.writerows((i,) for i in range(1000))
+    with open(output_file.name, "rb") as fp:
+        assert list(Reader(fp)) == [(i,) for i in range(1000)]
+    path = pathlib.Path(output_file.name)
+    with Writer(path, "int", collect_metrics=True) as writer:
+        writer.writerows(range(100))
+    assert writer.metrics["bytes_written"] == path.stat().st_size
+    assert writer.metrics["stripes"] == 1
+    with open(output_file.name, "rb") as fp:
+        assert list(Reader(fp)) == list(range(100))
+    with pytest.raises(OSError):
+        _ = Writer(os.path.join(output_file.name, "missing"), "int")
+
+
+class WriteLog(io.BytesIO):
+    def __init__(self):
+        super().__init__()
+        self.calls = 0
+
+    def write(self, data):
+        self.calls += 1
+        return super().write(data)
+
+
+@pytest.mark.parametrize("buffer_size", (0, 1024, 8388608))
+def test_write_buffer_size(buffer_size):
+    data = WriteLog()
+    writer = Writer(
+        data,
+        "struct<a:int,b:string>",
+        stripe_size=4096,
+        compression_block_size=1024,
+        memory_block_size=512,
+        write_buffer_size=buffer_size,
+    )
+    writer.writerows((i, "Test {0}".format(i)) for i in range(50000))
+    writer.close()
+    length = len(data.getvalue())
+    if buffer_size >= length:
+        # Only the file header and the complete buffer at closing.
+        assert data.calls == 2
+    else:
+        assert data.calls > 2
+    data.seek(0)
+    rows = list(Reader(data))
+    assert rows == [(i, "Test {0}".format(i)) for i in range(50000)]
+
+
+def test_write_keeps_chunks():
+    class ChunkList:
+        closed = False
+
+        def __init__(self):
+            self.chunks = []
+
+        def write(self, data):
+            self.chunks.append(data)
+
+        def flush(self):
+            pass
+
+    fileo = ChunkList()
+    with Writer(
+        fileo,
+        "struct<a:int,b:string>",
+        stripe_size=4096,
+        compression_block_size=1024,
+        memory_block_size=512,
+        write_buffer_size=2048,
+    ) as writer:
+        writer.writerows((i, "Test {0}".format(i)) for i in range(20000))
+    assert len(fileo.chunks) > 2
+    data = io.BytesIO(b"".join(fileo.chunks))
+    assert list(Reader(data)) == [(i, "Test {0}".format(i)) for i in range(20000)]
+
+
+def test_write_parallel(output_file):
+    output_file.close()
+    paths = ["{0}.{1}".format(output_file.name, i) for i in range(4)]
+    outputs = [io.BytesIO() for _ in range(4)]
+    errors = []
+
+    def write(fileo, num):
+        try:
+            schema = "struct<a:int,b:string>"
+            with Writer(fileo, schema, compression=CompressionKind.ZSTD) as writer:
+                writer.writerows((i + num, str(i)) for i in range(20000))
+        except Exception as exc:
+            errors.append(exc)
+
+    threads = [
+        threading.Thread(target=write, args=(fileo, num))
+        for num, fileo in enumerate(outputs + paths)
+    ]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert errors == []
+    try:
+        for num, fileo in enumerate(outputs + paths):
+            if isinstance(fileo, str):
+                fileo = open(fileo, "rb")
+            with fileo:
+                expected = [(i + num, str(i)) for i in range(20000)]
+                assert list(Reader(fileo)) == expected
+    finally:
+        for path in paths:
+            os.remove(path)
+
+
+class FailingStream(io.BytesIO):
+    def __init__(self, limit):
+        super().__init__()
+        self.limit = limit
+
+    def write(self, data):
+        if self.tell() + len(data) > self.limit:
+            raise OSError("No space left")
+        return super().write(data)
+
+
+def test_async_flush(output_file):
+    schema = "struct<a:int,b:string,c:array<double>>"
+    rows = [(i, "Test {0}".format(i), [i / 2] * (i % 4)) for i in range(50000)]
+    data = io.BytesIO()
+    with Writer(
+        data, schema, batch_size=100, async_flush=True, collect_metrics=True
+    ) as writer:
+        writer.writerows(rows)
+        assert writer.metrics["add_call"] == 500
+        assert writer.current_row == 50000
+    data.seek(0)
+    assert list(Reader(data)) == rows
+    output_file.close()
+    with Writer(output_file.name, schema, async_flush=True) as writer:
+        for row in rows:
+            writer.write(row)
+    with open(output_file.name, "rb") as fp:
+        assert list(Reader(fp)) == rows
+    data = io.BytesIO()
+    with Writer(data, "struct<a:int,b:string>", async_flush=True) as writer:
+        writer.write_batch(
+            {
+                "a": array.array("i", range(3000)),
+                "b": (array.array("i", range(3001)), b"x" * 3000),
+            }
+        )
+    data.seek(0)
+    assert list(Reader(data)) == [(i, "x") for i in range(3000)]
+
+
+def test_async_flush_error():
+    data = FailingStream(1024)
+    writer = Writer(
+        data,
+        "struct<a:int,b:string>",
+        batch_size=100,
+        stripe_size=1024,
+        compression_block_size=1024,
+        memory_block_size=512,
+        write_buffer_size=0,
+        async_flush=True,
+    )
+    with pytest.raises(OSError, match="No space left"):
+        writer.writerows((i, "Test {0}".format(i)) for i in range(50000))
+        writer.close()
+
+
+def test_write_temporary_strings():
+    data = io.BytesIO()
+    sizes = [0, 1, 100, 70000, 300000]
+    with Writer(
+        data, "struct<a:string,b:binary,c:array<string>>", batch_size=50
+    ) as writer:
+        for i in range(500):
+            size = sizes[i % len(sizes)]
+            # The objects are released right after the write.
+            writer.write(
+                (chr(65 + i % 26) * size, bytes([i % 256]) * size, [str(i)] * (i % 3))
+            )
+    data.seek(0)
+    for i, row in enumerate(Reader(data)):
+        size = sizes[i % len(sizes)]
+        assert row == (
+            chr(65 + i % 26) * size,
+            bytes([i % 256]) * size,
+            [str(i)] * (i % 3),
+        )
+
+
+class PyDateConverter(DateConverter):
+    pass
+
+
+class PyDecimalConverter(DecimalConverter):
+    pass
+
+
+class PyTimestampConverter(TimestampConverter):
+    pass
+
+
+def test_native_conversions():
+    schema = "struct<a:timestamp,b:date,c:decimal(10,3),d:decimal(30,4)>"
+    tzs = [
+        timezone.utc,
+        timezone(timedelta(hours=-5, minutes=-30)),
+        zi.ZoneInfo("Europe/Budapest"),
+        zi.ZoneInfo("America/New_York"),
+    ]
+    rows = []
+    for i in range(2000):
+        timestamp = datetime(
+            1900 + i % 200,
+            1 + i % 12,
+            1 + i % 28,
+            i % 24,
+            i % 60,
+            i % 60,
+            i * 7919 % 1000000,
+            tzinfo=tzs[i % 4],
+        )
+        day = date(1 + i * 5 % 9999, 1 + i % 12, 1 + i % 28)
+        dec64 = Decimal(i * 7 - 5000).scaleb(-(i % 5))
+        dec128 = Decimal("-1.5E+{0}".format(i % 20)) if i % 3 else Decimal("1.23456")
+        rows.append((timestamp, day, dec64, dec128))
+    native = io.BytesIO()
+    with Writer(native, schema) as writer:
+        writer.writerows(rows)
+    python = io.BytesIO()
+    with Writer(
+        python,
+        schema,
+        converters={
+            TypeKind.DATE: PyDateConverter,
+            TypeKind.DECIMAL: PyDecimalConverter,
+            TypeKind.TIMESTAMP: PyTimestampConverter,
+        },
+    ) as writer:
+        writer.writerows(rows)
+    assert native.getvalue() == python.getvalue()
+    with pytest.raises(TypeError):
+        with Writer(io.BytesIO(), "struct<a:date>") as writer:
+            writer.write((datetime(2021, 1, 1),))
+    with pytest.raises(TypeError):
+        with Writer(io.BytesIO(), "struct<a:decimal(10,3)>") as writer:
+            writer.write((1.5,))
+
+
+def test_write_nested_growing():
+    data = io.BytesIO()
+    schema = "struct<a:array<struct<b:int,c:array<string>>>,d:map<int,array<int>>>"
+    rows = [
+        (
+            [(j, [str(j)] * (j % 4)) for j in range(i % 50)],
+            {j: list(range(j)) for j in range(i % 7)},
+        )
+        for i in range(3000)
+    ]
+    with Writer(data, schema, batch_size=500) as writer:
+        writer.writerows(rows)
+    data.seek(0)
+    assert list(Reader(data)) == rows
+    writer = Writer(io.BytesIO(), "struct<a:int,b:array<int>>")
+    with pytest.raises(TypeError, match="at struct field index 1"):
+        writer.write((0, 1))
+    with pytest.raises(IndexError):
+        writer.write((0,))
+    writer.write((1, (i for i in range(3))))
+    writer.write((2, range(2)))
+
+
+def test_sort_by():
+    with pytest.raises(TypeError):
+        _ = Writer(io.BytesIO(), "int", sort_by=["a"])
+    with pytest.raises(ValueError):
+        _ = Writer(io.BytesIO(), "struct<a:int>", sort_by=["b"])
+    with pytest.raises(ValueError):
+        _ = Writer(io.BytesIO(), "struct<a:array<int>>", sort_by=["a"])
+    with pytest.raises(ValueError):
+        _ = Writer(io.BytesIO(), "struct<a:int>", sort_by=["a"], async_flush=True)
+    with pytest.raises(ValueError):
+        _ = Writer(io.BytesIO(), "struct<a:int>", sort_by=["a"], sort_buffer_rows=0)
+    data = io.BytesIO()
+    schema = "struct<a:string,b:int,c:array<double>,d:map<string,int>>"
+    rows = [
+        (
+            None if i % 13 == 0 else "k{0}".format(i * 7 % 10),
+            i,
+            [float(i)] * (i % 3),
+            {str(i): i} if i % 4 else None,
+        )
+        for i in range(2500)
+    ]
+    with Writer(
+        data, schema, batch_size=100, sort_by=["a"], sort_buffer_rows=1000
+    ) as writer:
+        writer.writerows(rows)
+    data.seek(0)
+    result = list(Reader(data))
+    assert len(result) == len(rows)
+    for start in range(0, len(rows), 1000):
+        expected = sorted(
+            rows[start : start + 1000],
+            key=lambda row: (row[0] is not None, row[0] or ""),
+        )
+        assert result[start : start + 1000] == expected
+
+
+def test_sort_by_predicate():
+    rows = [((i * 7919) % 5000, (i * 31) % 17, str(i)) for i in range(5000)]
+    data = io.BytesIO()
+    with Writer(
+        data,
+        "struct<a:int,b:bigint,c:string>",
+        row_index_stride=100,
+        sort_by=["a", "b"],
+    ) as writer:
+        writer.writerows(rows)
+    data.seek(0)
+    assert list(Reader(data)) == sorted(rows, key=lambda row: (row[0], row[1]))
+    data.seek(0)
+    reader = Reader(data, predicate=PredicateColumn(TypeKind.INT, "a") < 50)
+    assert len(list(reader)) == 100
+    data = io.BytesIO()
+    with Writer(
+        data, "struct<a:double,b:int>", sort_by=["a"], sort_buffer_rows=3
+    ) as writer:
+        writer.write_batch(
+            {
+                "a": array.array("d", [3.0, float("nan"), -1.0, 2.0, 1.0]),
+                "b": array.array("i", [0, 1, 2, 3, 4]),
+            }
+        )
+    data.seek(0)
+    assert [row[1] for row in Reader(data)] == [2, 0, 1, 4, 3]